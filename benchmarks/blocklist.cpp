@@ -0,0 +1,59 @@
+#include "bloom_filter.hpp"
+#include "rcu.hpp"
+#include "steam_id_set.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Same snapshot as blocklist_snapshot in fake_block.cpp, which checks the bloom filter (if it's
+ * enabled) and then the set. That file needs Steam, so the snapshot is rebuilt here.
+ */
+struct blocklist {
+    gg::steam_id_set ids;
+    optional<gg::bloom_filter> filter;
+
+    blocklist(vector<uint64_t> list, bool use_filter) : ids(move(list)) {
+        if (use_filter && !ids.empty()) {
+            filter.emplace(ids.ids(), .01);
+        }
+    }
+
+    bool contains(uint64_t id) const {
+        return (!filter || filter->may_contain(id)) && ids.contains(id);
+    }
+};
+
+static vector<uint64_t> random_steam_ids(size_t count, unsigned int seed) {
+    auto rng = mt19937_64{seed};
+    auto account = uniform_int_distribution<uint64_t>{1, 0xffffffff};
+    auto ids = vector<uint64_t>(count);
+    for (auto &id : ids) {
+        id = 76561197960265728ull + account(rng);
+    }
+    return ids;
+}
+
+/**
+ * Look up players that aren't blocked, which is almost every lookup in a real session. Each lookup
+ * goes through an rcu_ptr read guard like is_player_blocked() does. Arguments are the list size and
+ * whether the bloom filter is enabled.
+ */
+static void BM_is_player_blocked(benchmark::State &state) {
+    auto blocked = gg::rcu_ptr<blocklist>{
+        make_unique<blocklist>(random_steam_ids(state.range(0), 1), state.range(1) != 0)};
+    auto players = random_steam_ids(1024, 2);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(blocked.read()->contains(players[i++ & 1023]));
+    }
+}
+
+BENCHMARK(BM_is_player_blocked)->ArgsProduct({{10, 10'000, 1'000'000}, {0, 1}});
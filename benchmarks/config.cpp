@@ -0,0 +1,45 @@
+#include "keycodes.hpp"
+#include "rules.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string_view>
+#include <utility>
+
+using namespace std;
+
+/**
+ * The parts of loading ergg.ini that do real work on each value. Reading the file goes through
+ * mINI and the Windows module path, so it isn't included.
+ */
+static constexpr pair<string_view, string_view> example_rules[] = {
+    {"laggy", "ping > 250 for 30s => warn"},
+    {"impossible_level", "level outside 1-713 => block"},
+    {"cheater", "name matches \"*cheat*\" and level > 400 => block"},
+    {"stuck", "ping > 300 for 20s and level < 30 => block"},
+};
+
+static constexpr string_view example_keys[] = {
+    "graveaccent", "f2", "f3", "tab", "f4", "f5", "keypad0",
+};
+
+static void BM_config_compile_rules(benchmark::State &state) {
+    for (auto _ : state) {
+        auto program = gg::rules::program{};
+        for (auto &[name, text] : example_rules) {
+            gg::rules::compile(name, text, program);
+        }
+        benchmark::DoNotOptimize(program.instructions.data());
+    }
+}
+
+static void BM_config_find_keys(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto name : example_keys) {
+            benchmark::DoNotOptimize(gg::keycodes::find(name));
+        }
+    }
+}
+
+BENCHMARK(BM_config_compile_rules);
+BENCHMARK(BM_config_find_keys);
@@ -0,0 +1,17 @@
+#include "logs.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace std;
+
+/**
+ * Log a typical message into the ring buffer, as the overlay sink does. Several threads log at
+ * once in the mod, so this also measures contention on the buffer's lock.
+ */
+static void BM_logs_log(benchmark::State &state) {
+    for (auto _ : state) {
+        gg::logs::log("Blocked player 76561197960287930 for 30 minutes");
+    }
+}
+
+BENCHMARK(BM_logs_log)->ThreadRange(1, 8)->UseRealTime();
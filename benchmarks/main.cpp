@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Budgets are read from benchmarks/budgets.txt, which has one benchmark name and its maximum
+ * real time per iteration in nanoseconds on each line. Lines starting with # are comments.
+ *
+ * @returns the budgets, or nullopt if the file can't be read or has an invalid line
+ */
+static optional<map<string, double>> load_budgets(const string &path) {
+    auto file = ifstream{path};
+    if (!file) {
+        fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return nullopt;
+    }
+
+    auto budgets = map<string, double>{};
+    auto line = string{};
+    while (getline(file, line)) {
+        auto stream = istringstream{line};
+        auto name = string{};
+        auto budget_ns = 0.0;
+        if (!(stream >> name) || name.starts_with('#')) {
+            continue;
+        }
+        if (!(stream >> budget_ns)) {
+            fprintf(stderr, "Invalid budget for %s in %s\n", name.c_str(), path.c_str());
+            return nullopt;
+        }
+        budgets[name] = budget_ns;
+    }
+    return budgets;
+}
+
+/**
+ * Prints results like the default console reporter, and remembers any benchmark that was slower
+ * than its budget or has no budget at all, so they can be listed at the end
+ */
+class budget_reporter : public benchmark::ConsoleReporter {
+private:
+    const map<string, double> &budgets;
+    vector<string> regressions;
+    vector<string> unbudgeted;
+
+public:
+    explicit budget_reporter(const map<string, double> &budgets) : budgets(budgets) {}
+
+    void ReportRuns(const vector<Run> &runs) override {
+        ConsoleReporter::ReportRuns(runs);
+
+        for (auto &run : runs) {
+            if (run.run_type != Run::RT_Iteration) {
+                continue;
+            }
+
+            auto name = run.benchmark_name();
+            auto budget = budgets.find(name);
+            if (budget == budgets.end()) {
+                unbudgeted.push_back(name);
+                continue;
+            }
+
+            auto time_ns =
+                run.GetAdjustedRealTime() / benchmark::GetTimeUnitMultiplier(run.time_unit) * 1e9;
+            if (time_ns > budget->second) {
+                auto message = ostringstream{};
+                message << name << ": " << time_ns << " ns, budget " << budget->second << " ns";
+                regressions.push_back(message.str());
+            }
+        }
+    }
+
+    /**
+     * @returns true if every benchmark has a budget and was within it
+     */
+    bool report_regressions() const {
+        if (regressions.empty() && unbudgeted.empty()) {
+            printf("All benchmarks are within their budgets\n");
+            return true;
+        }
+
+        if (!regressions.empty()) {
+            printf("%zu benchmarks are over budget:\n", regressions.size());
+            for (auto &regression : regressions) {
+                printf("  %s\n", regression.c_str());
+            }
+        }
+        if (!unbudgeted.empty()) {
+            printf("%zu benchmarks have no budget in budgets.txt:\n", unbudgeted.size());
+            for (auto &name : unbudgeted) {
+                printf("  %s\n", name.c_str());
+            }
+        }
+        return false;
+    }
+};
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // The budget file can be passed as the only argument not handled by Google Benchmark
+    auto budgets_path = string{argc > 1 ? argv[1] : ERGG_BENCH_BUDGETS};
+    if (argc > 2) {
+        benchmark::ReportUnrecognizedArguments(argc, argv);
+        return 1;
+    }
+
+    auto budgets = load_budgets(budgets_path);
+    if (!budgets) {
+        return 1;
+    }
+
+    auto reporter = budget_reporter{*budgets};
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    return reporter.report_regressions() ? 0 : 1;
+}
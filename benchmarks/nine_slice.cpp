@@ -0,0 +1,18 @@
+#include "gui/nine_slice.hpp"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * Geometry for the player list background, which is drawn once for the container and once for
+ * each row every frame
+ */
+static void BM_nine_slice(benchmark::State &state) {
+    auto pos = ImVec2{1200.f, 80.f};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pos);
+        auto geometry = gg::gui::nine_slice({256.f, 256.f}, pos, {480.f, 360.f}, {56.f, 56.f});
+        benchmark::DoNotOptimize(geometry);
+    }
+}
+
+BENCHMARK(BM_nine_slice);
@@ -0,0 +1,82 @@
+#include "events.hpp"
+#include "ping_smoother.hpp"
+#include "rules.hpp"
+#include "steam_id_set.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+/**
+ * The portable work done for each player in one update_player_list() call at 60 FPS: checking the
+ * blocklist, smoothing their ping, publishing a sample once a second, and running the auto-block
+ * rules over the snapshot. Reading the game's player data and Steam calls aren't included, since
+ * those need the game to be running.
+ */
+static void BM_player_list_tick(benchmark::State &state) {
+    // Something has to be listening, or publish() doesn't queue anything
+    [[maybe_unused]] static auto subscribed = [] {
+        gg::events::subscribe<gg::events::ping_sampled>(
+            gg::events::delivery::render,
+            [](const gg::events::ping_sampled &event) { benchmark::DoNotOptimize(event.ping); });
+        return true;
+    }();
+
+    auto player_count = static_cast<size_t>(state.range(0));
+
+    auto program = gg::rules::program{};
+    gg::rules::compile("laggy", "ping > 250 for 30s => warn", program);
+    gg::rules::compile("impossible_level", "level outside 1-713 => block", program);
+    gg::rules::compile("cheater", "name matches \"*cheat*\" => block", program);
+    auto evaluator = gg::rules::evaluator{program};
+    auto matches = vector<gg::rules::match>{};
+
+    auto blocked = vector<uint64_t>(1'000);
+    for (size_t i = 0; i < blocked.size(); i++) {
+        blocked[i] = 76561197960265728ull + i * 7919;
+    }
+    auto blocklist = gg::steam_id_set{move(blocked)};
+
+    auto pings = vector<gg::ping_smoother>(player_count);
+    auto snapshot = vector<gg::rules::player_facts>(player_count);
+    for (size_t i = 0; i < player_count; i++) {
+        snapshot[i] = {
+            .steam_id = 76561198000000000ull + i,
+            .in_game_name = "tarnished",
+            .steam_name = "tarnished",
+            .ping = 0,
+            .rune_level = 150,
+        };
+    }
+
+    auto now = chrono::steady_clock::time_point{};
+    int64_t now_ms = 0;
+    int frame = 0;
+    for (auto _ : state) {
+        now += chrono::microseconds{16'667};
+        now_ms += 17;
+        frame++;
+
+        for (size_t i = 0; i < player_count; i++) {
+            auto &player = snapshot[i];
+            benchmark::DoNotOptimize(blocklist.contains(player.steam_id));
+
+            auto ping = 40 + (frame + static_cast<int>(i) * 13) % 30;
+            pings[i].update(ping);
+            if (pings[i].sample(ping, now)) {
+                gg::events::publish(gg::events::ping_sampled{player.steam_id, ping});
+            }
+            player.ping = pings[i].value;
+        }
+
+        evaluator.evaluate(snapshot, now_ms, matches);
+        matches.clear();
+
+        gg::events::dispatch();
+    }
+}
+
+BENCHMARK(BM_player_list_tick)->Arg(1)->Arg(6)->Arg(32);
@@ -0,0 +1,24 @@
+#include <benchmark/benchmark.h>
+
+#include <codecvt>
+#include <locale>
+#include <string>
+
+using namespace std;
+
+/**
+ * In-game names are UTF-16 and are converted to UTF-8 whenever a player joins or their name is
+ * refreshed. player_list.cpp converts from wchar_t, which is only 16 bits on Windows, so this
+ * uses char16_t to measure the same conversion on every platform.
+ */
+static void BM_utf16_name(benchmark::State &state) {
+    static wstring_convert<codecvt_utf8_utf16<char16_t>, char16_t> utf16_convert;
+
+    auto name = state.range(0) ? u16string{u"褪色者 the Tarnished"} : u16string{u"Tarnished"};
+    for (auto _ : state) {
+        auto utf8 = utf16_convert.to_bytes(name);
+        benchmark::DoNotOptimize(utf8.data());
+    }
+}
+
+BENCHMARK(BM_utf16_name)->Arg(0)->Arg(1);
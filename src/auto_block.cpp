@@ -0,0 +1,150 @@
+#include "auto_block.hpp"
+#include "config.hpp"
+#include "events.hpp"
+#include "fake_block.hpp"
+#include "trace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+using namespace std;
+
+static constexpr auto snapshot_interval = chrono::milliseconds{500};
+
+struct pending_match {
+    gg::rules::match match;
+    string name;
+    string rule_name;
+};
+
+/**
+ * Players are checked as soon as they join, rather than waiting for the next snapshot
+ */
+static auto last_snapshot = chrono::steady_clock::time_point{};
+
+static mutex auto_block_mutex;
+static condition_variable snapshot_ready;
+static optional<vector<gg::rules::player_facts>> pending_snapshot;
+static shared_ptr<const gg::rules::program> pending_rules;
+static vector<pending_match> pending_matches;
+
+static int64_t steady_time_ms() {
+    return chrono::duration_cast<chrono::milliseconds>(
+               chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void lowercase(string &text) {
+    ranges::transform(text, text.begin(),
+                      [](unsigned char c) { return static_cast<char>(tolower(c)); });
+}
+
+static void evaluate_snapshots() {
+    GG_TRACE_THREAD("auto block");
+
+    auto rules = shared_ptr<const gg::rules::program>{};
+    auto evaluator = optional<gg::rules::evaluator>{};
+    auto matches = vector<gg::rules::match>{};
+
+    while (true) {
+        auto snapshot = vector<gg::rules::player_facts>{};
+        {
+            auto lock = unique_lock{auto_block_mutex};
+            snapshot_ready.wait(lock, [] { return pending_snapshot.has_value(); });
+            snapshot = move(*pending_snapshot);
+            pending_snapshot.reset();
+
+            // When the config is reloaded, start over with the new rules
+            if (rules != pending_rules) {
+                rules = pending_rules;
+                evaluator.emplace(*rules);
+            }
+        }
+
+        GG_TRACE_ZONE("evaluate rules");
+
+        // Keep the original names for logging, since names are matched in lowercase
+        auto names = vector<string>{};
+        for (auto &facts : snapshot) {
+            names.push_back(facts.in_game_name);
+            lowercase(facts.in_game_name);
+            lowercase(facts.steam_name);
+        }
+
+        matches.clear();
+        evaluator->evaluate(snapshot, steady_time_ms(), matches);
+        if (matches.empty()) {
+            continue;
+        }
+
+        auto lock = lock_guard{auto_block_mutex};
+        for (auto &match : matches) {
+            auto facts = ranges::find(snapshot, match.steam_id, &gg::rules::player_facts::steam_id);
+            pending_matches.push_back(
+                {match, names[facts - snapshot.begin()], rules->rule_names[match.rule]});
+        }
+    }
+}
+
+void gg::auto_block::start() {
+    gg::events::subscribe<gg::events::player_joined>(
+        gg::events::delivery::render,
+        [](const gg::events::player_joined &) { last_snapshot = {}; });
+
+    thread(evaluate_snapshots).detach();
+}
+
+bool gg::auto_block::wants_snapshot() {
+    if (gg::config::auto_block_rules->empty()) {
+        return false;
+    }
+
+    auto now = chrono::steady_clock::now();
+    if (now - last_snapshot < snapshot_interval) {
+        return false;
+    }
+
+    last_snapshot = now;
+    return true;
+}
+
+void gg::auto_block::submit(vector<rules::player_facts> &&snapshot) {
+    {
+        auto lock = lock_guard{auto_block_mutex};
+        pending_snapshot = move(snapshot);
+        pending_rules = gg::config::auto_block_rules;
+    }
+    snapshot_ready.notify_one();
+}
+
+void gg::auto_block::apply_actions() {
+    auto matches = vector<pending_match>{};
+    {
+        auto lock = lock_guard{auto_block_mutex};
+        if (pending_matches.empty()) {
+            return;
+        }
+        matches.swap(pending_matches);
+    }
+
+    for (auto &[match, name, rule_name] : matches) {
+        auto steam_id = CSteamID{match.steam_id};
+
+        if (match.act == rules::action::block) {
+            if (!is_player_blocked(steam_id)) {
+                SPDLOG_WARN("Auto-blocking {} ({}): rule \"{}\"", name, match.steam_id, rule_name);
+                block_player(steam_id);
+            }
+        } else {
+            SPDLOG_WARN("Warning: {} ({}) matched rule \"{}\"", name, match.steam_id, rule_name);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "rules.hpp"
+
+#include <vector>
+
+namespace gg {
+namespace auto_block {
+
+/**
+ * Start the background thread that evaluates the auto-block rules from the config. The thread is
+ * idle while there are no rules.
+ */
+void start();
+
+/**
+ * @returns true if it's time to pass a new snapshot of the player list to submit(). Snapshots are
+ * only needed a few times per second, since sustained conditions are measured in seconds.
+ */
+bool wants_snapshot();
+
+/**
+ * Hand a snapshot of the players in the session to the background thread, along with the current
+ * rules. If the previous snapshot hasn't been evaluated yet, it's replaced.
+ */
+void submit(std::vector<rules::player_facts> &&snapshot);
+
+/**
+ * Block or warn about players that matched a rule since the last call. Called from the render
+ * thread, so blocks are applied in the same place as manual ones.
+ */
+void apply_actions();
+
+}
+}
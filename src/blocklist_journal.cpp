@@ -0,0 +1,379 @@
+#include "blocklist_journal.hpp"
+#include "blocklists.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * How long to wait after a change for more changes to write in the same batch
+ */
+static constexpr auto batch_delay = chrono::milliseconds{100};
+
+/**
+ * Number of journaled changes before they're compacted into a new snapshot
+ */
+static constexpr size_t compaction_threshold = 256;
+
+enum class record_type : uint32_t {
+    block = 1,
+    unblock = 2,
+
+    // A temporary block is written as two records, so the journal stays a list of fixed-size
+    // records. The value of the second record is the expiration time.
+    block_until = 3,
+    expires = 4,
+};
+
+struct journal_record {
+    uint64_t value;
+    record_type type;
+    uint32_t checksum;
+};
+
+static_assert(sizeof(journal_record) == 16);
+
+static uint32_t compute_checksum(uint64_t value, record_type type) {
+    // FNV-1a over the record contents, enough to detect a torn or partially written record
+    auto hash = 0x811c9dc5u;
+    auto bytes = value ^ (static_cast<uint64_t>(type) << 59);
+    for (int i = 0; i < 8; i++) {
+        hash = (hash ^ static_cast<uint8_t>(bytes >> (i * 8))) * 0x01000193u;
+    }
+    return hash;
+}
+
+static journal_record make_record(uint64_t value, record_type type) {
+    return {value, type, compute_checksum(value, type)};
+}
+
+static bool is_valid(const journal_record &record) {
+    return record.type >= record_type::block && record.type <= record_type::expires &&
+           record.checksum == compute_checksum(record.value, record.type);
+}
+
+static int64_t unix_time() {
+    return chrono::duration_cast<chrono::seconds>(
+               chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+struct journal_sets {
+    unordered_set<uint64_t> blocked;
+    unordered_set<uint64_t> unblocked;
+
+    /**
+     * Expiration times of temporarily blocked players, who are also in the blocked set
+     */
+    unordered_map<uint64_t, int64_t> expires;
+
+    void block(uint64_t steam_id, int64_t expiration) {
+        blocked.insert(steam_id);
+        unblocked.erase(steam_id);
+        if (expiration) {
+            expires[steam_id] = expiration;
+        } else {
+            expires.erase(steam_id);
+        }
+    }
+
+    void unblock(uint64_t steam_id) {
+        blocked.erase(steam_id);
+        expires.erase(steam_id);
+        unblocked.insert(steam_id);
+    }
+
+    /**
+     * Apply the changes in the given records, stopping at the first invalid or incomplete one
+     *
+     * @returns the number of records applied
+     */
+    size_t replay(span<const journal_record> records) {
+        size_t count = 0;
+        while (count < records.size() && is_valid(records[count])) {
+            auto &record = records[count];
+            if (record.type == record_type::block) {
+                block(record.value, 0);
+                count++;
+            } else if (record.type == record_type::unblock) {
+                unblock(record.value);
+                count++;
+            } else if (record.type == record_type::block_until && count + 1 < records.size() &&
+                       is_valid(records[count + 1]) &&
+                       records[count + 1].type == record_type::expires) {
+                block(record.value, static_cast<int64_t>(records[count + 1].value));
+                count += 2;
+            } else {
+                break;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * Forget temporary blocks that have already expired
+     */
+    void remove_expired(int64_t now) {
+        erase_if(expires, [&](auto &entry) {
+            if (entry.second > now) return false;
+            blocked.erase(entry.first);
+            return true;
+        });
+    }
+};
+
+static vector<uint64_t> sorted(const unordered_set<uint64_t> &ids) {
+    auto result = vector<uint64_t>{ids.begin(), ids.end()};
+    ranges::sort(result);
+    return result;
+}
+
+gg::blocklist_journal::state gg::blocklist_journal::recover(const fs::path &snapshot_path,
+                                                            const fs::path &journal_path) {
+    auto sets = journal_sets{};
+
+    // The snapshot has one blocked ID per line, optionally followed by an expiration time.
+    // Unblocked IDs are prefixed with "-".
+    {
+        auto file = gg::platform::mapped_file{snapshot_path};
+        auto text = string_view{file.data().data(), file.data().size()};
+
+        for (size_t line_begin = 0; line_begin < text.size();) {
+            auto line_end = text.find('\n', line_begin);
+            if (line_end == string_view::npos) {
+                line_end = text.size();
+            }
+
+            auto line = text.substr(line_begin, line_end - line_begin);
+            line_begin = line_end + 1;
+
+            auto is_unblock = line.starts_with('-');
+            if (is_unblock) {
+                line.remove_prefix(1);
+            }
+
+            auto end = line.data() + line.size();
+            uint64_t steam_id = 0;
+            auto [steam_id_end, ec] = from_chars(line.data(), end, steam_id);
+            if (ec != errc{} || steam_id == 0) {
+                continue;
+            }
+
+            if (is_unblock) {
+                sets.unblock(steam_id);
+            } else {
+                int64_t expiration = 0;
+                auto expiration_begin = steam_id_end;
+                while (expiration_begin < end && *expiration_begin == ' ') {
+                    expiration_begin++;
+                }
+                from_chars(expiration_begin, end, expiration);
+                sets.block(steam_id, expiration);
+            }
+        }
+    }
+
+    // Replay changes made since the snapshot, stopping at the first incomplete record
+    auto valid_size = size_t{0};
+    {
+        auto file = gg::platform::mapped_file{journal_path};
+        auto data = file.data();
+        auto records = span{reinterpret_cast<const journal_record *>(data.data()),
+                            data.size() / sizeof(journal_record)};
+
+        auto valid_count = sets.replay(records);
+        if (valid_count > 0) {
+            SPDLOG_INFO("Recovered {} blocklist changes from {}", valid_count,
+                        journal_path.string());
+        }
+
+        valid_size = valid_count * sizeof(journal_record);
+        if (valid_size < data.size()) {
+            SPDLOG_WARN("Ignoring {} bytes of incomplete blocklist changes in {}",
+                        data.size() - valid_size, journal_path.string());
+        }
+    }
+
+    sets.remove_expired(unix_time());
+
+    auto result = state{};
+    for (auto id : sorted(sets.blocked)) {
+        if (auto it = sets.expires.find(id); it != sets.expires.end()) {
+            result.temporary.push_back({id, it->second});
+        } else {
+            result.blocked.push_back(id);
+        }
+    }
+    result.unblocked = sorted(sets.unblocked);
+    result.journal_size = valid_size;
+    return result;
+}
+
+static mutex pending_mutex;
+static condition_variable pending_condition;
+static vector<journal_record> pending_records;
+
+static bool write_all(HANDLE file, const void *data, size_t size) {
+    DWORD written;
+    return WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr) && written == size;
+}
+
+/**
+ * Write the current state to a new snapshot file, atomically replace the old one, and then
+ * truncate the journal. If the game crashes in between, replaying the journal over the new
+ * snapshot gives the same result.
+ */
+static bool compact(const fs::path &snapshot_path, HANDLE journal, journal_sets &sets) {
+    sets.remove_expired(unix_time());
+
+    auto text = string{};
+    for (auto id : sorted(sets.blocked)) {
+        text += to_string(id);
+        if (auto it = sets.expires.find(id); it != sets.expires.end()) {
+            text += ' ';
+            text += to_string(it->second);
+        }
+        text += '\n';
+    }
+    for (auto id : sorted(sets.unblocked)) {
+        text += '-';
+        text += to_string(id);
+        text += '\n';
+    }
+
+    auto temp_path = fs::path{snapshot_path}.concat(".tmp");
+    auto temp_file = CreateFileW(temp_path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                 FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (temp_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    auto written = write_all(temp_file, text.data(), text.size()) && FlushFileBuffers(temp_file);
+    CloseHandle(temp_file);
+
+    if (!written || !MoveFileExW(temp_path.c_str(), snapshot_path.c_str(),
+                                 MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        return false;
+    }
+
+    return SetFilePointer(journal, 0, nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER &&
+           SetEndOfFile(journal) && FlushFileBuffers(journal);
+}
+
+static void writer_main(fs::path snapshot_path, HANDLE journal, journal_sets sets) {
+    LARGE_INTEGER journal_size;
+    auto journal_count = GetFileSizeEx(journal, &journal_size)
+                             ? static_cast<size_t>(journal_size.QuadPart) / sizeof(journal_record)
+                             : 0;
+
+    auto try_compact = [&] {
+        if (compact(snapshot_path, journal, sets)) {
+            journal_count = 0;
+        } else {
+            SPDLOG_ERROR("Failed to compact blocklist to {} ({})", snapshot_path.string(),
+                         GetLastError());
+        }
+    };
+
+    // Anything recovered from the journal can be compacted right away
+    if (journal_count > 0) {
+        try_compact();
+    }
+
+    auto batch = vector<journal_record>{};
+    while (true) {
+        {
+            auto lock = unique_lock{pending_mutex};
+            pending_condition.wait(lock, [] { return !pending_records.empty(); });
+        }
+
+        this_thread::sleep_for(batch_delay);
+
+        {
+            auto lock = lock_guard{pending_mutex};
+            batch.swap(pending_records);
+        }
+
+        // A torn write is detected on the next load, so the whole batch can be written and
+        // flushed at once
+        if (!write_all(journal, batch.data(), batch.size() * sizeof(journal_record)) ||
+            !FlushFileBuffers(journal)) {
+            SPDLOG_ERROR("Failed to write blocklist changes ({})", GetLastError());
+        }
+
+        sets.replay(batch);
+        journal_count += batch.size();
+        batch.clear();
+
+        if (journal_count >= compaction_threshold) {
+            try_compact();
+        }
+    }
+}
+
+void gg::blocklist_journal::start(const fs::path &snapshot_path,
+                                  const fs::path &journal_path,
+                                  state initial_state) {
+    auto journal = CreateFileW(journal_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                               nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (journal == INVALID_HANDLE_VALUE) {
+        SPDLOG_ERROR("Failed to open {} ({}), blocklist changes won't be saved",
+                     journal_path.string(), GetLastError());
+        return;
+    }
+
+    // Append after the last record that was replayed. Replay stops at the first bad record, so
+    // anything after it, even whole records, would hide new changes on the next load.
+    auto journal_size = LARGE_INTEGER{};
+    journal_size.QuadPart = static_cast<LONGLONG>(initial_state.journal_size);
+    if (!SetFilePointerEx(journal, journal_size, nullptr, FILE_BEGIN) || !SetEndOfFile(journal)) {
+        SPDLOG_ERROR("Failed to truncate {} ({}), blocklist changes won't be saved",
+                     journal_path.string(), GetLastError());
+        CloseHandle(journal);
+        return;
+    }
+
+    auto sets = journal_sets{};
+    for (auto id : initial_state.blocked) {
+        sets.block(id, 0);
+    }
+    for (auto &temporary_block : initial_state.temporary) {
+        sets.block(temporary_block.steam_id, temporary_block.expires);
+    }
+    for (auto id : initial_state.unblocked) {
+        sets.unblock(id);
+    }
+
+    thread(writer_main, snapshot_path, journal, move(sets)).detach();
+}
+
+void gg::blocklist_journal::append(uint64_t steam_id, bool blocked, int64_t expires) {
+    {
+        auto lock = lock_guard{pending_mutex};
+        if (!blocked) {
+            pending_records.push_back(make_record(steam_id, record_type::unblock));
+        } else if (!expires) {
+            pending_records.push_back(make_record(steam_id, record_type::block));
+        } else {
+            pending_records.push_back(make_record(steam_id, record_type::block_until));
+            pending_records.push_back(
+                make_record(static_cast<uint64_t>(expires), record_type::expires));
+        }
+    }
+    pending_condition.notify_one();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace gg {
+namespace blocklist_journal {
+
+struct temporary_block {
+    uint64_t steam_id;
+
+    /**
+     * Unix time in seconds when the block ends
+     */
+    int64_t expires;
+};
+
+/**
+ * Players the user has blocked or unblocked themselves. Unblocks are saved too, so they can
+ * override players that are on a shared blocklist.
+ */
+struct state {
+    std::vector<uint64_t> blocked;
+    std::vector<temporary_block> temporary;
+    std::vector<uint64_t> unblocked;
+
+    /**
+     * Bytes at the start of the journal that were replayed. Anything after them is a torn or
+     * corrupt record, and is cut off when the journal is reopened for writing.
+     */
+    uint64_t journal_size{0};
+};
+
+/**
+ * Load the last compacted snapshot and replay any changes journaled since then. If the game
+ * crashed while a change was being written, the incomplete record is ignored. Temporary blocks
+ * that have already expired are left out.
+ */
+state recover(const std::filesystem::path &snapshot_path,
+              const std::filesystem::path &journal_path);
+
+/**
+ * Start the background thread that appends changes to the journal and periodically compacts it
+ * into a new snapshot
+ */
+void start(const std::filesystem::path &snapshot_path,
+           const std::filesystem::path &journal_path,
+           state initial_state);
+
+/**
+ * Queue a change to be written to the journal. This doesn't block on disk I/O, and changes are
+ * made durable in small batches.
+ *
+ * @param expires Unix time when a block ends, or 0 for a permanent block
+ */
+void append(uint64_t steam_id, bool blocked, int64_t expires = 0);
+
+}
+}
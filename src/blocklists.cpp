@@ -0,0 +1,185 @@
+#include "blocklists.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * Binary blocklists are this header followed by `count` sorted, unique SteamID64s. The IDs start
+ * at a 16 byte offset, so they're aligned when the file is mapped directly into memory.
+ */
+struct binary_header {
+    char magic[8];
+    uint64_t count;
+};
+
+static constexpr char binary_magic[8] = {'E', 'R', 'G', 'G', 'B', 'L', '0', '1'};
+
+static inline uint64_t load_eight_chars(const char *chars) {
+    uint64_t value;
+    memcpy(&value, chars, sizeof(value));
+    return value;
+}
+
+static inline bool is_eight_digits(uint64_t chars) {
+    return ((chars & 0xf0f0f0f0f0f0f0f0ull) |
+            (((chars + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) ==
+           0x3333333333333333ull;
+}
+
+/**
+ * Convert 8 ASCII digits to an integer at once using SWAR arithmetic
+ *
+ * http://0x80.pl/articles/swar-digits-to-number.html
+ */
+static inline uint64_t parse_eight_digits(uint64_t chars) {
+    chars -= 0x3030303030303030ull;
+    chars = (chars * 10) + (chars >> 8);
+    return (((chars & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+            (((chars >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >>
+           32;
+}
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+vector<uint64_t> gg::blocklists::parse_text(string_view text) {
+    auto ids = vector<uint64_t>{};
+
+    // SteamID64s are 17 digits, so this is a close estimate for lists without comments
+    ids.reserve(text.size() / 18);
+
+    auto p = text.data();
+    auto end = p + text.size();
+
+    if (text.starts_with("\xef\xbb\xbf")) {
+        p += 3;
+    }
+
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) {
+            p++;
+        }
+
+        // Find the end of the number 8 characters at a time
+        auto digits_begin = p;
+        while (end - p >= 8 && is_eight_digits(load_eight_chars(p))) {
+            p += 8;
+        }
+        while (p < end && is_digit(*p)) {
+            p++;
+        }
+
+        // Anything longer than 19 digits would overflow
+        auto length = p - digits_begin;
+        if (length > 0 && length <= 19) {
+            auto digits = digits_begin;
+            uint64_t id = 0;
+            for (auto leading = length % 8; leading > 0; leading--) {
+                id = id * 10 + (*digits++ - '0');
+            }
+            for (; digits < p; digits += 8) {
+                id = id * 100000000ull + parse_eight_digits(load_eight_chars(digits));
+            }
+            if (id != 0) {
+                ids.push_back(id);
+            }
+        }
+
+        // Skip comments or anything else after the ID
+        auto line_end = static_cast<const char *>(memchr(p, '\n', end - p));
+        p = line_end ? line_end + 1 : end;
+    }
+
+    return ids;
+}
+
+optional<span<const uint64_t>> gg::blocklists::read_binary(
+    const gg::platform::mapped_file &file) {
+    auto data = file.data();
+    if (data.size() < sizeof(binary_header)) {
+        return nullopt;
+    }
+
+    auto header = reinterpret_cast<const binary_header *>(data.data());
+    if (memcmp(header->magic, binary_magic, sizeof(binary_magic)) != 0 ||
+        header->count > (data.size() - sizeof(binary_header)) / sizeof(uint64_t)) {
+        return nullopt;
+    }
+
+    auto ids = span{reinterpret_cast<const uint64_t *>(data.data() + sizeof(binary_header)),
+                    static_cast<size_t>(header->count)};
+
+    // Merging assumes every list is sorted without duplicates, which a file written by something
+    // else might not be
+    if (ranges::adjacent_find(ids, greater_equal{}) != ids.end()) {
+        return nullopt;
+    }
+
+    return ids;
+}
+
+bool gg::blocklists::write_binary(const fs::path &path, span<const uint64_t> sorted_ids) {
+    auto temp_path = fs::path{path}.concat(".tmp");
+
+    auto header = binary_header{.magic = {}, .count = sorted_ids.size()};
+    memcpy(header.magic, binary_magic, sizeof(binary_magic));
+
+    auto stream = ofstream{temp_path, ios::binary | ios::trunc};
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char *>(sorted_ids.data()), sorted_ids.size_bytes());
+    stream.close();
+    if (stream.fail()) {
+        return false;
+    }
+
+    auto ec = error_code{};
+    fs::rename(temp_path, path, ec);
+    return !ec;
+}
+
+vector<uint64_t> gg::blocklists::merge(span<const span<const uint64_t>> sources) {
+    auto total = size_t{0};
+    for (auto &source : sources) {
+        total += source.size();
+    }
+
+    auto merged = vector<uint64_t>{};
+    merged.reserve(total);
+
+    // Min-heap of the next unmerged ID from each source
+    struct cursor {
+        uint64_t id;
+        size_t source;
+        size_t index;
+
+        bool operator>(const cursor &other) const { return id > other.id; }
+    };
+    auto heap = priority_queue<cursor, vector<cursor>, greater<cursor>>{};
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!sources[i].empty()) {
+            heap.push({sources[i][0], i, 0});
+        }
+    }
+
+    while (!heap.empty()) {
+        auto next = heap.top();
+        heap.pop();
+
+        if (merged.empty() || merged.back() != next.id) {
+            merged.push_back(next.id);
+        }
+
+        auto &source = sources[next.source];
+        if (++next.index < source.size()) {
+            next.id = source[next.index];
+            heap.push(next);
+        }
+    }
+
+    return merged;
+}
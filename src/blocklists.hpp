@@ -0,0 +1,40 @@
+#pragma once
+
+#include "platform/mapped_file.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gg {
+namespace blocklists {
+
+/**
+ * Parse a plain text blocklist with one SteamID64 per line. Anything after the ID on a line, and
+ * lines that don't start with an ID, are ignored so lists can contain comments.
+ */
+std::vector<uint64_t> parse_text(std::string_view text);
+
+/**
+ * Get the sorted IDs stored in a binary blocklist file, without copying or parsing them. The span
+ * is only valid while the file is mapped.
+ *
+ * @returns nullopt if the file isn't a valid binary blocklist, or its IDs aren't sorted and unique
+ */
+std::optional<std::span<const uint64_t>> read_binary(const platform::mapped_file &file);
+
+/**
+ * Write sorted, unique IDs to a binary blocklist file, replacing any existing file atomically
+ */
+bool write_binary(const std::filesystem::path &path, std::span<const uint64_t> sorted_ids);
+
+/**
+ * Merge several sorted lists of IDs into a single sorted list without duplicates
+ */
+std::vector<uint64_t> merge(std::span<const std::span<const uint64_t>> sources);
+
+}
+}
@@ -0,0 +1,74 @@
+#include "bloom_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+using namespace std;
+
+static constexpr unsigned int bits_per_block = 512;
+
+/**
+ * MurmurHash3 finalizer. SteamIDs only differ in their low bits, so they need to be mixed before
+ * being used to pick a block and bits.
+ */
+static inline uint64_t mix(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    id *= 0xc4ceb9fe1a85ec53ull;
+    id ^= id >> 33;
+    return id;
+}
+
+/**
+ * Which block an ID belongs to, and the two hashes that are combined to pick bits within it
+ */
+struct probe {
+    size_t block;
+    uint32_t h1;
+    uint32_t h2;
+
+    probe(uint64_t id, size_t block_count) {
+        auto hash = mix(id);
+        block = static_cast<size_t>(((hash >> 32) * block_count) >> 32);
+        h1 = static_cast<uint32_t>(hash);
+        h2 = static_cast<uint32_t>((hash * 0x9e3779b97f4a7c15ull) >> 32) | 1;
+    }
+
+    unsigned int bit(unsigned int i) const { return (h1 + i * h2) % bits_per_block; }
+};
+
+gg::bloom_filter::bloom_filter(span<const uint64_t> ids, double false_positive_rate) {
+    false_positive_rate = clamp(false_positive_rate, 1e-6, .5);
+
+    // Optimal size and number of hashes for a standard Bloom filter. Some blocks end up more
+    // loaded than others, so the blocked layout needs a bit more space to hit the same rate.
+    auto bits_per_id = -log(false_positive_rate) / (numbers::ln2 * numbers::ln2);
+    hash_count = clamp(static_cast<unsigned int>(lround(bits_per_id * numbers::ln2)), 1u, 16u);
+    bits_per_id *= 1.25;
+
+    auto bit_count = static_cast<size_t>(ceil(max<size_t>(ids.size(), 1) * bits_per_id));
+    blocks.resize((bit_count + bits_per_block - 1) / bits_per_block, block{});
+
+    for (auto id : ids) {
+        auto p = probe{id, blocks.size()};
+        auto &b = blocks[p.block];
+        for (unsigned int i = 0; i < hash_count; i++) {
+            auto bit = p.bit(i);
+            b.words[bit / 64] |= 1ull << (bit % 64);
+        }
+    }
+}
+
+bool gg::bloom_filter::may_contain(uint64_t id) const {
+    auto p = probe{id, blocks.size()};
+    auto &b = blocks[p.block];
+    for (unsigned int i = 0; i < hash_count; i++) {
+        auto bit = p.bit(i);
+        if (!(b.words[bit / 64] & (1ull << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gg {
+
+/**
+ * Cache-blocked Bloom filter over 64-bit SteamIDs. Every ID maps to a single 64 byte block, so a
+ * query touches one cache line no matter how large the filter is. Used to quickly reject IDs that
+ * definitely aren't in a large set before doing an exact lookup.
+ */
+class bloom_filter {
+private:
+    struct alignas(64) block {
+        uint64_t words[8];
+    };
+
+    std::vector<block> blocks;
+    unsigned int hash_count;
+
+public:
+    /**
+     * Build a filter containing the given IDs, sized so that lookups for IDs that weren't added
+     * return true with roughly the given probability
+     */
+    bloom_filter(std::span<const uint64_t> ids, double false_positive_rate);
+
+    /**
+     * @returns false if the ID was definitely not added, or true if it probably was
+     */
+    bool may_contain(uint64_t id) const;
+
+    size_t size_bytes() const { return blocks.size() * sizeof(block); }
+};
+
+}
@@ -1,123 +1,408 @@
 #include "config.hpp"
+#include "keycodes.hpp"
+#include "trace.hpp"
+#include "platform/module.hpp"
+#include "platform/watch_directory.hpp"
 
 #include <imgui.h>
 #include <mini/ini.h>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
-#include <unordered_map>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <variant>
+#include <vector>
 
 using namespace std;
 namespace fs = std::filesystem;
 
-static HINSTANCE mod_handle;
+static void *mod_handle;
 
 fs::path gg::config::mod_folder;
 
-bool gg::config::show_in_game_name = true;
-bool gg::config::show_level = true;
-bool gg::config::show_steam_name = true;
-bool gg::config::show_steam_avatar = true;
-bool gg::config::show_steam_relationship = true;
-bool gg::config::show_ping = true;
-unsigned int gg::config::high_ping = 100;
-bool gg::config::show_yourself = false;
-
-ImGuiKey gg::config::toggle_logs_key = ImGuiKey_GraveAccent;
-ImGuiKey gg::config::toggle_player_list_key = ImGuiKey_F2;
-ImGuiKey gg::config::block_player_key = ImGuiKey_F3;
-ImGuiKey gg::config::disconnect_key = ImGuiKey_F4;
-
-bool gg::config::debug = false;
-
-static void try_parse_boolean(mINI::INIMap<string> &config, const string &name, bool &out) {
-    if (!config.has(name)) {
-        SPDLOG_WARN("Missing config \"{}\"", name);
-        return;
-    }
+bool gg::config::show_in_game_name;
+bool gg::config::show_level;
+bool gg::config::show_steam_name;
+bool gg::config::show_steam_avatar;
+bool gg::config::show_steam_relationship;
+bool gg::config::show_ping;
+unsigned int gg::config::high_ping;
+bool gg::config::show_yourself;
+string gg::config::player_list_columns;
+unsigned int gg::config::telemetry_rate;
 
-    auto &value = config[name];
-    if (value == "true") {
-        out = true;
-    } else if (value == "false") {
-        out = false;
-    } else {
-        SPDLOG_WARN("Invalid config value \"{} = {}\"", name, value);
-    }
+bool gg::config::bloom_filter;
+double gg::config::bloom_filter_false_positive_rate;
+
+shared_ptr<const gg::rules::program> gg::config::auto_block_rules =
+    make_shared<gg::rules::program>();
+
+ImGuiKey gg::config::toggle_logs_key;
+ImGuiKey gg::config::toggle_player_list_key;
+ImGuiKey gg::config::block_player_key;
+ImGuiKey gg::config::block_duration_key;
+ImGuiKey gg::config::disconnect_key;
+ImGuiKey gg::config::toggle_settings_key;
+ImGuiKey gg::config::toggle_network_details_key;
+ImGuiKey gg::config::capture_trace_key;
+ImGuiKey gg::config::toggle_memory_key;
+
+bool gg::config::debug;
+unsigned int gg::config::trace_seconds;
+bool gg::config::trace_startup;
+
+unsigned int gg::config::vram_budget_mb;
+unsigned int gg::config::ram_budget_mb;
+
+unsigned int gg::config::fake_steam_players;
+double gg::config::fake_steam_churn;
+string gg::config::fake_steam_ping_trace;
+double gg::config::fake_steam_call_latency_min;
+double gg::config::fake_steam_call_latency_max;
+
+unsigned int gg::config::revision = 0;
+
+void gg::config::set_handle(void *mod_handle) {
+    ::mod_handle = mod_handle;
+    mod_folder = gg::platform::get_module_folder(mod_handle);
+}
+
+using option_value = variant<bool, unsigned int, double, ImGuiKey, string>;
+using option_target = variant<bool *, unsigned int *, double *, ImGuiKey *, string *>;
+
+/**
+ * Same as option_value, but with a literal for string options so the schema can be constexpr
+ */
+using option_default = variant<bool, unsigned int, double, ImGuiKey, const char *>;
+
+/**
+ * One entry in ergg.ini. Parsing, validation, logging, and the default ini written when the file
+ * is missing are all driven by this table, so adding an option only means declaring its global
+ * and adding a row here.
+ */
+struct option {
+    string_view section;
+    string_view name;
+    option_target target;
+    option_default default_value;
+    string_view description;
+
+    /**
+     * Inclusive range for numeric options
+     */
+    double min{0};
+    double max{0};
 };
 
+using namespace gg::config;
+
 // clang-format off
-static unordered_map<string, ImGuiKey> keycodes_by_name = {{
-    {"tab", ImGuiKey_Tab}, {"leftarrow", ImGuiKey_LeftArrow}, {"rightarrow", ImGuiKey_RightArrow},
-    {"uparrow", ImGuiKey_UpArrow}, {"downarrow", ImGuiKey_DownArrow}, {"pageup", ImGuiKey_PageUp},
-    {"pagedown", ImGuiKey_PageDown}, {"home", ImGuiKey_Home}, {"end", ImGuiKey_End},
-    {"insert", ImGuiKey_Insert}, {"delete", ImGuiKey_Delete}, {"backspace", ImGuiKey_Backspace},
-    {"space", ImGuiKey_Space}, {"enter", ImGuiKey_Enter}, {"escape", ImGuiKey_Escape},
-    {"leftctrl", ImGuiKey_LeftCtrl}, {"leftshift", ImGuiKey_LeftShift},
-    {"leftalt", ImGuiKey_LeftAlt}, {"leftsuper", ImGuiKey_LeftSuper},
-    {"rightctrl", ImGuiKey_RightCtrl}, {"rightshift", ImGuiKey_RightShift},
-    {"rightalt", ImGuiKey_RightAlt}, {"rightsuper", ImGuiKey_RightSuper},
-    {"menu", ImGuiKey_Menu}, {"0", ImGuiKey_0}, {"1", ImGuiKey_1}, {"2", ImGuiKey_2},
-    {"3", ImGuiKey_3}, {"4", ImGuiKey_4}, {"5", ImGuiKey_5}, {"6", ImGuiKey_6}, {"7", ImGuiKey_7},
-    {"8", ImGuiKey_8}, {"9", ImGuiKey_9}, {"a", ImGuiKey_A}, {"b", ImGuiKey_B}, {"c", ImGuiKey_C},
-    {"d", ImGuiKey_D}, {"e", ImGuiKey_E}, {"f", ImGuiKey_F}, {"g", ImGuiKey_G}, {"h", ImGuiKey_H},
-    {"i", ImGuiKey_I}, {"j", ImGuiKey_J}, {"k", ImGuiKey_K}, {"l", ImGuiKey_L}, {"m", ImGuiKey_M},
-    {"n", ImGuiKey_N}, {"o", ImGuiKey_O}, {"p", ImGuiKey_P}, {"q", ImGuiKey_Q}, {"r", ImGuiKey_R},
-    {"s", ImGuiKey_S}, {"t", ImGuiKey_T}, {"u", ImGuiKey_U}, {"v", ImGuiKey_V}, {"w", ImGuiKey_W},
-    {"x", ImGuiKey_X}, {"y", ImGuiKey_Y}, {"z", ImGuiKey_Z}, {"f1", ImGuiKey_F1},
-    {"f2", ImGuiKey_F2}, {"f3", ImGuiKey_F3}, {"f4", ImGuiKey_F4}, {"f5", ImGuiKey_F5},
-    {"f6", ImGuiKey_F6}, {"f7", ImGuiKey_F7}, {"f8", ImGuiKey_F8}, {"f9", ImGuiKey_F9},
-    {"f10", ImGuiKey_F10}, {"f11", ImGuiKey_F11}, {"f12", ImGuiKey_F12}, {"f13", ImGuiKey_F13},
-    {"f14", ImGuiKey_F14}, {"f15", ImGuiKey_F15}, {"f16", ImGuiKey_F16}, {"f17", ImGuiKey_F17},
-    {"f18", ImGuiKey_F18}, {"f19", ImGuiKey_F19}, {"f20", ImGuiKey_F20}, {"f21", ImGuiKey_F21},
-    {"f22", ImGuiKey_F22}, {"f23", ImGuiKey_F23}, {"f24", ImGuiKey_F24},
-    {"apostrophe", ImGuiKey_Apostrophe}, {"comma", ImGuiKey_Comma}, {"minus", ImGuiKey_Minus},
-    {"period", ImGuiKey_Period}, {"slash", ImGuiKey_Slash}, {"semicolon", ImGuiKey_Semicolon},
-    {"equal", ImGuiKey_Equal}, {"leftbracket", ImGuiKey_LeftBracket},
-    {"backslash", ImGuiKey_Backslash}, {"rightbracket", ImGuiKey_RightBracket},
-    {"graveaccent", ImGuiKey_GraveAccent}, {"capslock", ImGuiKey_CapsLock},
-    {"scrolllock", ImGuiKey_ScrollLock}, {"numlock", ImGuiKey_NumLock},
-    {"printscreen", ImGuiKey_PrintScreen}, {"pause", ImGuiKey_Pause}, {"keypad0", ImGuiKey_Keypad0},
-    {"keypad1", ImGuiKey_Keypad1}, {"keypad2", ImGuiKey_Keypad2}, {"keypad3", ImGuiKey_Keypad3},
-    {"keypad4", ImGuiKey_Keypad4}, {"keypad5", ImGuiKey_Keypad5}, {"keypad6", ImGuiKey_Keypad6},
-    {"keypad7", ImGuiKey_Keypad7}, {"keypad8", ImGuiKey_Keypad8}, {"keypad9", ImGuiKey_Keypad9},
-    {"keypaddecimal", ImGuiKey_KeypadDecimal}, {"keypaddivide", ImGuiKey_KeypadDivide},
-    {"keypadmultiply", ImGuiKey_KeypadMultiply}, {"keypadsubtract", ImGuiKey_KeypadSubtract},
-    {"keypadadd", ImGuiKey_KeypadAdd}, {"keypadenter", ImGuiKey_KeypadEnter},
-    {"keypadequal", ImGuiKey_KeypadEqual}, {"appback", ImGuiKey_AppBack},
-    {"appforward", ImGuiKey_AppForward}, {"gamepadstart", ImGuiKey_GamepadStart},
-}};
+static constexpr auto schema = array{
+    option{"overlay", "show_in_game_name", &show_in_game_name, true,
+           "Show each character's in-game name"},
+    option{"overlay", "show_level", &show_level, true,
+           "Show each character's rune level"},
+    option{"overlay", "show_steam_name", &show_steam_name, true,
+           "Show each player's Steam name"},
+    option{"overlay", "show_steam_avatar", &show_steam_avatar, true,
+           "Show each player's Steam avatar, if available"},
+    option{"overlay", "show_steam_relationship", &show_steam_relationship, true,
+           "Highlight Steam friends in green, and players blocked on Steam in red"},
+    option{"overlay", "show_ping", &show_ping, true,
+           "Show each player's ping"},
+    option{"overlay", "high_ping", &high_ping, 100u,
+           "Ping above this many milliseconds is shown in red", 0, 10000},
+    option{"overlay", "show_yourself", &show_yourself, false,
+           "Include your own character in the list"},
+    option{"overlay", "columns", &player_list_columns, "avatar, name, level, ping",
+           "Columns in the player list, in order"},
+    option{"overlay", "telemetry_rate", &telemetry_rate, 10u,
+           "How many times per second each player's HP, FP and level are sampled", 1, 60},
+    option{"blocklist", "bloom_filter", &bloom_filter, true,
+           "Check a compact filter before the full blocklist"},
+    option{"blocklist", "bloom_filter_false_positive_rate", &bloom_filter_false_positive_rate, .01,
+           "How often the filter may report a false match", .0001, .5},
+    option{"actions", "toggle_logs", &toggle_logs_key, ImGuiKey_GraveAccent,
+           "Show or hide the event log"},
+    option{"actions", "toggle_player_list", &toggle_player_list_key, ImGuiKey_F2,
+           "Show or hide the player list"},
+    option{"actions", "block_player", &block_player_key, ImGuiKey_F3,
+           "Press followed by a number to block or unblock a player"},
+    option{"actions", "block_duration", &block_duration_key, ImGuiKey_Tab,
+           "While blocking, switch between permanent and temporary blocks"},
+    option{"actions", "disconnect", &disconnect_key, ImGuiKey_F4,
+           "Press twice to leave a session"},
+    option{"actions", "toggle_settings", &toggle_settings_key, ImGuiKey_F5,
+           "Show or hide the settings panel"},
+    option{"actions", "toggle_network_details", &toggle_network_details_key, ImGuiKey_F6,
+           "Show or hide connection details under each player"},
+    option{"actions", "capture_trace", &capture_trace_key, ImGuiKey_F7,
+           "Record what the mod is doing on each thread to a trace file"},
+    option{"actions", "toggle_memory", &toggle_memory_key, ImGuiKey_F8,
+           "Show or hide the memory usage page in debug mode"},
+    option{"misc", "debug", &debug, false,
+           "Show a console with detailed logs"},
+    option{"misc", "trace_seconds", &trace_seconds, 5u,
+           "How many seconds each trace records", 1, 60},
+    option{"misc", "trace_startup", &trace_startup, false,
+           "Record a trace as soon as the game starts"},
+    option{"memory", "vram_budget_mb", &vram_budget_mb, 64u,
+           "Video memory the overlay's textures may use before caches are evicted", 1, 4096},
+    option{"memory", "ram_budget_mb", &ram_budget_mb, 32u,
+           "Memory the overlay may use before caches are evicted", 1, 4096},
+    option{"fake_steam", "players", &fake_steam_players, 3u,
+           "Players in the fake session toggled with numpad 0 in debug mode", 0, 32},
+    option{"fake_steam", "churn", &fake_steam_churn, 0.,
+           "Fake players replaced by new ones per minute", 0, 600},
+    option{"fake_steam", "ping_trace", &fake_steam_ping_trace, "40, 45, 42, 60, 150, 45",
+           "Ping of each fake player in milliseconds, one value per second, repeated"},
+    option{"fake_steam", "call_latency_min", &fake_steam_call_latency_min, 0.,
+           "Shortest time each Steam call about a fake player takes, in milliseconds", 0, 100},
+    option{"fake_steam", "call_latency_max", &fake_steam_call_latency_max, 0.,
+           "Longest time each Steam call about a fake player takes, in milliseconds", 0, 100},
+};
 // clang-format on
 
-static void try_parse_keycode(mINI::INIMap<string> &config, const string &name, ImGuiKey &out) {
-    if (!config.has(name)) {
-        SPDLOG_WARN("Missing config \"{}\"", name);
-        return;
+static_assert(ranges::all_of(schema, [](const option &o) {
+    return o.target.index() == o.default_value.index();
+}));
+
+/**
+ * Values that can change when ergg.ini is reloaded. A new snapshot is parsed on the watcher thread
+ * and copied into the globals by the render task between frames, so they never change partway
+ * through a frame.
+ */
+struct settings {
+    array<option_value, schema.size()> values;
+    shared_ptr<const gg::rules::program> auto_block_rules;
+};
+
+static option_value to_value(const option_default &default_value) {
+    return visit(
+        [](auto value) {
+            if constexpr (is_same_v<decltype(value), const char *>) {
+                return option_value{string{value}};
+            } else {
+                return option_value{value};
+            }
+        },
+        default_value);
+}
+
+static settings default_settings() {
+    auto s = settings{};
+    ranges::transform(schema, s.values.begin(),
+                      [](const option &o) { return to_value(o.default_value); });
+    s.auto_block_rules = make_shared<gg::rules::program>();
+    return s;
+}
+
+static settings current_settings() {
+    auto s = settings{};
+    ranges::transform(schema, s.values.begin(), [](const option &o) {
+        return visit([](auto *target) { return option_value{*target}; }, o.target);
+    });
+    s.auto_block_rules = auto_block_rules;
+    return s;
+}
+
+static void apply_settings(const settings &s) {
+    for (size_t i = 0; i < schema.size(); i++) {
+        visit([&](auto *target) { *target = get<remove_pointer_t<decltype(target)>>(s.values[i]); },
+              schema[i].target);
     }
+    auto_block_rules = s.auto_block_rules;
+    revision++;
+}
 
-    auto value = config[name];
-    ranges::transform(value, value.begin(), ::tolower);
+static string to_lower(string value) {
+    ranges::transform(value, value.begin(),
+                      [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return value;
+}
 
-    auto it = keycodes_by_name.find(value);
-    if (it != keycodes_by_name.end()) {
-        out = it->second;
-    } else {
-        SPDLOG_WARN("Invalid config value \"{} = {}\"", name, value);
+/**
+ * Parse and validate a value from ergg.ini. Booleans and key names are case insensitive, and
+ * strings are kept exactly as written.
+ */
+static optional<option_value> parse_value(const option &o, const string &value) {
+    switch (o.default_value.index()) {
+    case 0:
+        if (auto lower = to_lower(value); lower == "true" || lower == "false") {
+            return lower == "true";
+        }
+        return nullopt;
+    case 1: {
+        unsigned int result;
+        auto [end, ec] = from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != errc{} || end != value.data() + value.size() || result < o.min ||
+            result > o.max) {
+            return nullopt;
+        }
+        return result;
     }
-};
+    case 2: {
+        char *end;
+        auto result = strtod(value.c_str(), &end);
+        if (end == value.c_str() || *end != '\0' || !(result >= o.min && result <= o.max)) {
+            return nullopt;
+        }
+        return result;
+    }
+    case 3:
+        if (auto key = gg::keycodes::find(to_lower(value))) {
+            return *key;
+        }
+        return nullopt;
+    case 4:
+        return value;
+    }
+    return nullopt;
+}
 
-void gg::config::set_handle(HINSTANCE mod_handle) {
-    ::mod_handle = mod_handle;
+static string format_value(const option_value &value) {
+    switch (value.index()) {
+    case 0:
+        return get<bool>(value) ? "true" : "false";
+    case 1:
+        return to_string(get<unsigned int>(value));
+    case 2:
+        return format("{}", get<double>(value));
+    case 3:
+        return string{gg::keycodes::name(get<ImGuiKey>(value))};
+    default:
+        return get<string>(value);
+    }
+}
 
-    wchar_t dll_filename[MAX_PATH] = {0};
-    GetModuleFileNameW(mod_handle, dll_filename, MAX_PATH);
-    mod_folder = fs::path{dll_filename}.parent_path();
+/**
+ * Read ergg.ini into a new snapshot, starting from the last values read so that missing or invalid
+ * entries keep whatever was there before
+ */
+static optional<settings> read_settings(const fs::path &ini_path, settings s) {
+    auto file = mINI::INIFile{ini_path.string()};
+    auto ini = mINI::INIStructure{};
+    if (!file.read(ini)) {
+        SPDLOG_WARN("Failed to read config");
+        return nullopt;
+    }
+
+    for (size_t i = 0; i < schema.size(); i++) {
+        auto &o = schema[i];
+        auto &section = ini[string{o.section}];
+        auto name = string{o.name};
+        if (!section.has(name)) {
+            SPDLOG_WARN("Missing config \"{}\"", name);
+            continue;
+        }
+
+        auto &value = section[name];
+        if (auto parsed = parse_value(o, value)) {
+            s.values[i] = *parsed;
+        } else if (o.min != o.max) {
+            SPDLOG_WARN("Invalid config value \"{} = {}\", expected {} to {}", name, value, o.min,
+                        o.max);
+        } else {
+            SPDLOG_WARN("Invalid config value \"{} = {}\"", name, value);
+        }
+    }
+
+    // Rules are compiled once here, so evaluating them doesn't involve any parsing
+    auto rules = make_shared<gg::rules::program>();
+    for (auto &[name, rule] : ini["rules"]) {
+        gg::rules::compile(name, rule, *rules);
+    }
+    s.auto_block_rules = move(rules);
+
+    return s;
+}
+
+/**
+ * Write an ini with every option set to its default, for when ergg.ini is missing
+ */
+static void write_default_config(const fs::path &ini_path) {
+    auto file = ofstream{ini_path};
+    auto section = string_view{};
+    for (auto &o : schema) {
+        if (o.section != section) {
+            if (!section.empty()) {
+                file << "\n";
+            }
+            section = o.section;
+            file << "[" << section << "]\n";
+        }
+        file << "\n; " << o.description << "\n";
+        file << o.name << " = " << format_value(to_value(o.default_value)) << "\n";
+    }
+    file << "\n[rules]\n";
+}
+
+static void log_config() {
+    SPDLOG_INFO("mod_folder = {}", mod_folder.string());
+
+    for (auto &o : schema) {
+        auto value = visit([](auto *target) { return option_value{*target}; }, o.target);
+        SPDLOG_INFO("{} = {}", o.name, format_value(value));
+    }
+
+    for (auto &name : auto_block_rules->rule_names) {
+        SPDLOG_INFO("rule {}", name);
+    }
 }
 
 void gg::config::load() {
     auto ini_path = mod_folder / "ergg.ini";
     SPDLOG_INFO("Loading config from {}", ini_path.string());
 
+    if (!fs::exists(ini_path)) {
+        SPDLOG_WARN("Config is missing, writing the default config");
+        write_default_config(ini_path);
+    }
+
+    auto s = default_settings();
+    if (auto read = read_settings(ini_path, s)) {
+        s = move(*read);
+    }
+    apply_settings(s);
+    log_config();
+}
+
+/**
+ * Changes made in the settings panel, waiting to be written to ergg.ini
+ */
+static mutex save_mutex;
+static condition_variable save_requested;
+static optional<array<option_value, schema.size()>> pending_save;
+static chrono::steady_clock::time_point save_deadline;
+
+/**
+ * Modification time of ergg.ini after it was last saved, so the watcher doesn't reload our own
+ * changes
+ */
+static fs::file_time_type last_save_time;
+
+/**
+ * Wait this long after the last change before saving, so dragging a slider doesn't write the file
+ * every frame
+ */
+static constexpr auto save_delay = chrono::milliseconds{500};
+
+/**
+ * Update the values in ergg.ini that differ from the given ones. mINI only rewrites the lines that
+ * changed, so comments and formatting in the file are preserved.
+ */
+static void write_values(const array<option_value, schema.size()> &values) {
+    auto ini_path = mod_folder / "ergg.ini";
     auto file = mINI::INIFile{ini_path.string()};
     auto ini = mINI::INIStructure{};
     if (!file.read(ini)) {
@@ -125,70 +410,147 @@ void gg::config::load() {
         return;
     }
 
-    auto &overlay = ini["overlay"];
-    try_parse_boolean(overlay, "show_in_game_name", show_in_game_name);
-    try_parse_boolean(overlay, "show_level", show_level);
-    try_parse_boolean(overlay, "show_steam_name", show_steam_name);
-    try_parse_boolean(overlay, "show_steam_avatar", show_steam_avatar);
-    try_parse_boolean(overlay, "show_steam_relationship", show_steam_relationship);
-    try_parse_boolean(overlay, "show_ping", show_ping);
-    try_parse_boolean(overlay, "show_yourself", show_yourself);
+    for (size_t i = 0; i < schema.size(); i++) {
+        auto &o = schema[i];
+        auto &section = ini[string{o.section}];
+        auto name = string{o.name};
+        if (!section.has(name) || parse_value(o, section[name]) != values[i]) {
+            section[name] = format_value(values[i]);
+        }
+    }
 
-    if (overlay.has("high_ping")) {
-        high_ping = strtoul(overlay["high_ping"].data(), nullptr, 10);
-    } else {
-        SPDLOG_WARN("Missing config \"high_ping\"", high_ping);
+    if (!file.write(ini)) {
+        SPDLOG_WARN("Failed to save config");
+        return;
     }
 
-    auto &actions = ini["actions"];
-    try_parse_keycode(actions, "toggle_logs", toggle_logs_key);
-    try_parse_keycode(actions, "toggle_player_list", toggle_player_list_key);
-    try_parse_keycode(actions, "block_player", block_player_key);
-    try_parse_keycode(actions, "disconnect", disconnect_key);
+    auto ec = error_code{};
+    auto write_time = fs::last_write_time(ini_path, ec);
+    auto lock = lock_guard{save_mutex};
+    last_save_time = write_time;
+}
+
+static void write_pending_saves() {
+    GG_TRACE_THREAD("config writer");
 
-    auto &misc = ini["misc"];
-    try_parse_boolean(misc, "debug", debug);
+    auto lock = unique_lock{save_mutex};
+    while (true) {
+        save_requested.wait(lock, [] { return pending_save.has_value(); });
+        while (chrono::steady_clock::now() < save_deadline) {
+            save_requested.wait_until(lock, save_deadline);
+        }
 
-    SPDLOG_INFO("mod_folder = {}", mod_folder.string());
+        auto values = move(*pending_save);
+        pending_save.reset();
+
+        lock.unlock();
+        SPDLOG_INFO("Saving config");
+        {
+            GG_TRACE_ZONE("save config");
+            write_values(values);
+        }
+        lock.lock();
+    }
+}
+
+void gg::config::save() {
+    revision++;
+
+    static once_flag writer_started;
+    call_once(writer_started, [] { thread(write_pending_saves).detach(); });
+
+    {
+        auto lock = lock_guard{save_mutex};
+        pending_save = current_settings().values;
+        save_deadline = chrono::steady_clock::now() + save_delay;
+    }
+    save_requested.notify_one();
+}
+
+pair<unsigned int, unsigned int> gg::config::get_range(const unsigned int &setting) {
+    auto o = ranges::find_if(schema, [&](const option &o) {
+        return holds_alternative<unsigned int *>(o.target) &&
+               get<unsigned int *>(o.target) == &setting;
+    });
+    if (o == schema.end()) {
+        return {0, 0};
+    }
+    return {static_cast<unsigned int>(o->min), static_cast<unsigned int>(o->max)};
+}
+
+/**
+ * The most recently reloaded config, waiting to be applied by the render task
+ */
+static mutex reloaded_settings_mutex;
+static unique_ptr<const settings> reloaded_settings;
+static atomic<bool> has_reloaded_settings{false};
+
+/**
+ * Editors often save a file with several writes, or by writing a temporary file and renaming it,
+ * so wait for changes to settle before reading it
+ */
+static constexpr auto reload_delay = chrono::milliseconds{200};
 
-    SPDLOG_INFO("show_in_game_name = {}", show_in_game_name);
-    SPDLOG_INFO("show_level = {}", show_level);
-    SPDLOG_INFO("show_steam_name = {}", show_steam_name);
-    SPDLOG_INFO("show_steam_avatar = {}", show_steam_avatar);
-    SPDLOG_INFO("show_steam_relationship = {}", show_steam_relationship);
-    SPDLOG_INFO("show_ping = {}", show_ping);
-    SPDLOG_INFO("high_ping = {}", high_ping);
-    SPDLOG_INFO("show_yourself = {}", show_yourself);
+/**
+ * Only this thread reads the config after startup, so it keeps its own copy of the last values read
+ * rather than touching the globals the render task is using
+ */
+static void watch_config_folder(settings last_settings) {
+    GG_TRACE_THREAD("config watcher");
 
-    SPDLOG_INFO("toggle_player_list = 0x{:x}", (int)toggle_player_list_key);
-    SPDLOG_INFO("block_player = 0x{:x}", (int)block_player_key);
-    SPDLOG_INFO("disconnect = 0x{:x}", (int)disconnect_key);
+    auto ini_path = gg::config::mod_folder / "ergg.ini";
+    gg::platform::watch_directory(gg::config::mod_folder, [&](span<const fs::path> filenames) {
+        // No filenames means some changes were missed, so assume the config may have changed
+        auto config_changed = filenames.empty() || ranges::any_of(filenames, [](auto &filename) {
+                                  return to_lower(filename.string()) == "ergg.ini";
+                              });
+        if (!config_changed) {
+            return;
+        }
 
-    SPDLOG_INFO("debug = {}", debug);
+        this_thread::sleep_for(reload_delay);
+
+        {
+            auto ec = error_code{};
+            auto write_time = fs::last_write_time(ini_path, ec);
+            auto lock = lock_guard{save_mutex};
+            if (!ec && write_time == last_save_time) {
+                return;
+            }
+        }
+
+        GG_TRACE_ZONE("reload config");
+        SPDLOG_INFO("Reloading config");
+        auto s = read_settings(ini_path, last_settings);
+        if (!s) {
+            return;
+        }
+        last_settings = *s;
+
+        auto lock = lock_guard{reloaded_settings_mutex};
+        reloaded_settings = make_unique<const settings>(move(*s));
+        has_reloaded_settings = true;
+    });
+}
+
+void gg::config::watch() { thread(watch_config_folder, current_settings()).detach(); }
+
+void gg::config::update() {
+    if (!has_reloaded_settings.load(memory_order_acquire)) {
+        return;
+    }
+
+    auto s = unique_ptr<const settings>{};
+    {
+        auto lock = lock_guard{reloaded_settings_mutex};
+        s = move(reloaded_settings);
+        has_reloaded_settings = false;
+    }
+
+    apply_settings(*s);
+    log_config();
 }
 
 optional<span<unsigned char>> gg::config::get_resource(string name, string type) {
-    auto res = FindResourceA(mod_handle, name.data(), type.data());
-    if (!res) {
-        SPDLOG_CRITICAL("Failed to find mod resource ({}) {} {}", GetLastError(), name, type);
-        return {};
-    }
-    auto size = SizeofResource(mod_handle, res);
-    if (!size) {
-        SPDLOG_CRITICAL("Failed to get size of mod resource ({}) {} {}", GetLastError(), name,
-                        type);
-        return {};
-    }
-    auto handle = LoadResource(mod_handle, res);
-    if (!handle) {
-        SPDLOG_CRITICAL("Failed to load mod resource ({}) {} {}", GetLastError(), name, type);
-        return {};
-    }
-    auto data = reinterpret_cast<unsigned char *>(LockResource(handle));
-    if (!data) {
-        SPDLOG_CRITICAL("Failed to get mod resource data ({}) {} {}", GetLastError(), name, type);
-        return {};
-    }
-
-    return span{data, size};
-}
\ No newline at end of file
+    return gg::platform::get_module_resource(mod_handle, name, type);
+}
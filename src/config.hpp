@@ -1,13 +1,15 @@
 #pragma once
 
-#include <imgui.h>
+#include "rules.hpp"
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
+#include <imgui.h>
 
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
+#include <utility>
 
 namespace gg {
 namespace config {
@@ -22,17 +24,73 @@ extern bool show_steam_relationship;
 extern bool show_ping;
 extern unsigned int high_ping;
 extern bool show_yourself;
+extern std::string player_list_columns;
+extern unsigned int telemetry_rate;
+
+extern bool bloom_filter;
+extern double bloom_filter_false_positive_rate;
+
+extern std::shared_ptr<const rules::program> auto_block_rules;
 
 extern ImGuiKey toggle_logs_key;
 extern ImGuiKey toggle_player_list_key;
 extern ImGuiKey block_player_key;
+extern ImGuiKey block_duration_key;
 extern ImGuiKey disconnect_key;
+extern ImGuiKey toggle_settings_key;
+extern ImGuiKey toggle_network_details_key;
+extern ImGuiKey capture_trace_key;
+extern ImGuiKey toggle_memory_key;
 
 extern bool debug;
+extern unsigned int trace_seconds;
+extern bool trace_startup;
+
+extern unsigned int vram_budget_mb;
+extern unsigned int ram_budget_mb;
+
+extern unsigned int fake_steam_players;
+extern double fake_steam_churn;
+extern std::string fake_steam_ping_trace;
+extern double fake_steam_call_latency_min;
+extern double fake_steam_call_latency_max;
 
-void set_handle(HINSTANCE mod_handle);
+/**
+ * Incremented whenever the config changes, so anything derived from it can be rebuilt only when
+ * needed
+ */
+extern unsigned int revision;
+
+/**
+ * Remember the mod's DLL, which ergg.ini and the embedded resources are found relative to
+ */
+void set_handle(void *mod_handle);
 void load();
 
+/**
+ * Start watching ergg.ini for changes. When it's saved, it's parsed again on a background thread
+ * and the new values are applied by the next call to update().
+ */
+void watch();
+
+/**
+ * Apply the most recently reloaded config, if it changed. Called by the render task at the start of
+ * each frame.
+ */
+void update();
+
+/**
+ * Save the current values to ergg.ini after a short delay. The file is written on a background
+ * thread, so this can be called whenever a setting is changed without blocking the frame.
+ */
+void save();
+
+/**
+ * @returns the smallest and largest values allowed in ergg.ini for a numeric setting, so the
+ * settings panel can offer the same range
+ */
+std::pair<unsigned int, unsigned int> get_range(const unsigned int &setting);
+
 std::optional<std::span<unsigned char>> get_resource(std::string name, std::string type = "DATA");
 
 }
@@ -2,12 +2,15 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <string_view>
 #include <thread>
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
 #include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
@@ -19,32 +22,37 @@
 #include "gui/render_overlay.hpp"
 #include "logs.hpp"
 #include "renderer/renderer.hpp"
+#include "trace.hpp"
 
 using namespace std;
 namespace fs = std::filesystem;
 
-class overlay_sink : public spdlog::sinks::sink {
-protected:
-    unique_ptr<spdlog::formatter> formatter;
-
+/**
+ * Shows log messages in the overlay. Messages are logged from several background threads, so this
+ * derives from base_sink, which locks around the formatter.
+ */
+class overlay_sink : public spdlog::sinks::base_sink<mutex> {
 public:
     overlay_sink()
-        : formatter(make_unique<spdlog::pattern_formatter>("%v")) {}
+        : spdlog::sinks::base_sink<mutex>(make_unique<spdlog::pattern_formatter>("%v")) {}
 
-    virtual void log(const spdlog::details::log_msg &msg) {
-        formatter->format(msg, gg::logs::append());
+protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        auto formatted = spdlog::memory_buf_t{};
+        formatter_->format(msg, formatted);
+        gg::logs::log(string_view{formatted.data(), formatted.size()});
     }
 
-    virtual void flush() {}
-    virtual void set_pattern(const string &pattern) {}
-    virtual void set_formatter(unique_ptr<spdlog::formatter> sink_formatter) {}
+    void flush_() override {}
+    void set_pattern_(const string &pattern) override {}
+    void set_formatter_(unique_ptr<spdlog::formatter> sink_formatter) override {}
 };
 
 static shared_ptr<spdlog::logger> make_logger(const fs::path &path) {
     auto logger = make_shared<spdlog::logger>("gg");
     logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%n] %^[%l]%$ %v");
     logger->sinks().push_back(
-        make_shared<spdlog::sinks::daily_file_sink_st>(path.string(), 0, 0, false, 5));
+        make_shared<spdlog::sinks::daily_file_sink_mt>(path.string(), 0, 0, false, 5));
     logger->sinks().push_back(make_shared<overlay_sink>());
     spdlog::set_default_logger(logger);
     return logger;
@@ -56,7 +64,7 @@ static void enable_debug_logging(shared_ptr<spdlog::logger> logger) {
     freopen_s(&stream, "CONOUT$", "w", stdout);
     freopen_s(&stream, "CONOUT$", "w", stderr);
     freopen_s(&stream, "CONIN$", "r", stdin);
-    logger->sinks().push_back(make_shared<spdlog::sinks::stdout_color_sink_st>());
+    logger->sinks().push_back(make_shared<spdlog::sinks::stdout_color_sink_mt>());
     logger->flush_on(spdlog::level::info);
     logger->set_level(spdlog::level::trace);
 }
@@ -69,16 +77,33 @@ bool WINAPI DllMain(HINSTANCE instance, unsigned int reason, void *reserved) {
         auto logger = make_logger(gg::config::mod_folder / "logs" / "ergg.log");
         gg::config::load();
 
+        // Add the console sink before the config watcher starts logging from its own thread
         if (gg::config::debug) {
             enable_debug_logging(logger);
         }
 
+        gg::config::watch();
+
+        if (gg::config::trace_startup) {
+            gg::trace::start(chrono::seconds{gg::config::trace_seconds},
+                             gg::config::mod_folder / "traces");
+        }
+
         setup_thread = thread([]() {
+            GG_TRACE_THREAD("setup");
             try {
-                modutils::initialize();
+                {
+                    GG_TRACE_ZONE("modutils::initialize");
+                    modutils::initialize();
+                }
                 this_thread::sleep_for(chrono::seconds(2));
-                er::FD4::find_singletons();
-                gg::renderer::initialize(gg::gui::initialize_overlay, gg::gui::render_overlay);
+                {
+                    GG_TRACE_ZONE("find_singletons");
+                    er::FD4::find_singletons();
+                }
+                GG_TRACE_ZONE("renderer::initialize");
+                gg::renderer::initialize(gg::gui::initialize_overlay, gg::gui::update_overlay,
+                                         gg::gui::render_overlay);
             } catch (runtime_error &e) {
                 SPDLOG_ERROR("{}", e.what());
             }
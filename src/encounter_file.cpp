@@ -0,0 +1,65 @@
+#include "encounter_file.hpp"
+
+#include <spdlog/spdlog.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+bool gg::encounter_file::open(const fs::path &path) {
+    this->path = path;
+
+    // If the game closed partway through writing a record, drop it. Otherwise every record
+    // appended after it would be read at the wrong offset.
+    auto ec = error_code{};
+    auto existing_size = fs::file_size(path, ec);
+    if (!ec && existing_size % sizeof(record) != 0) {
+        SPDLOG_WARN("Removing an incomplete record from the end of {}", path.string());
+        fs::resize_file(path, existing_size - existing_size % sizeof(record), ec);
+        if (ec) {
+            SPDLOG_ERROR("Failed to truncate {} ({})", path.string(), ec.message());
+            return false;
+        }
+    }
+
+    file.open(path, ios::in | ios::out | ios::binary | ios::app);
+    return file.is_open();
+}
+
+uint64_t gg::encounter_file::size() {
+    auto size = static_cast<uint64_t>(file.seekg(0, ios::end).tellg());
+    file.clear();
+    return size - size % sizeof(record);
+}
+
+optional<gg::encounter_file::record> gg::encounter_file::read(uint64_t offset) {
+    auto r = record{};
+    file.seekg(offset);
+    if (!file.read(reinterpret_cast<char *>(&r), sizeof(r))) {
+        file.clear();
+        return nullopt;
+    }
+    return r;
+}
+
+optional<uint64_t> gg::encounter_file::append(const record &r) {
+    file.seekp(0, ios::end);
+    auto offset = static_cast<uint64_t>(file.tellp());
+    if (!file.write(reinterpret_cast<const char *>(&r), sizeof(r)).flush()) {
+        SPDLOG_ERROR("Failed to write to {}", path.string());
+        file.clear();
+        return nullopt;
+    }
+    return offset;
+}
+
+void gg::encounter_file::scan(uint64_t from,
+                              const function<void(const record &r, uint64_t offset)> &callback) {
+    auto end = size();
+    for (auto offset = from; offset < end; offset += sizeof(record)) {
+        auto r = read(offset);
+        if (!r) {
+            break;
+        }
+        callback(*r, offset);
+    }
+}
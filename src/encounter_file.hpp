@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <optional>
+
+namespace gg {
+
+/**
+ * encounters.dat, the append-only list of changes to each player's history. Each change is
+ * written as a complete record, so the file is always a whole number of records long, apart from
+ * one that was being written when the game closed.
+ */
+class encounter_file {
+public:
+    struct record {
+        uint64_t steam_id{0};
+
+        /**
+         * Unix times in seconds
+         */
+        int64_t first_seen{0};
+        int64_t last_seen{0};
+
+        uint32_t times_met{0};
+        uint32_t blocked{0};
+        int64_t ping_sum{0};
+        uint32_t ping_samples{0};
+        uint32_t reserved{0};
+
+        /**
+         * UTF-8, truncated and null-terminated
+         */
+        char in_game_name[64]{};
+        char steam_name[64]{};
+    };
+
+private:
+    std::filesystem::path path;
+    std::fstream file;
+
+public:
+    /**
+     * Open the file for appending, creating it if it doesn't exist. A record that was only partly
+     * written is cut off first, so the records appended after it stay aligned.
+     */
+    bool open(const std::filesystem::path &path);
+
+    /**
+     * @returns the size of the file in bytes, which is always a multiple of the record size
+     */
+    uint64_t size();
+
+    std::optional<record> read(uint64_t offset);
+
+    /**
+     * @returns the offset the record was written at, or nullopt if it couldn't be written
+     */
+    std::optional<uint64_t> append(const record &r);
+
+    /**
+     * Call a function with each record from the given offset to the end of the file
+     */
+    void scan(uint64_t from, const std::function<void(const record &r, uint64_t offset)> &callback);
+};
+
+static_assert(sizeof(encounter_file::record) == 176);
+
+}
@@ -0,0 +1,400 @@
+#include "encounters.hpp"
+#include "config.hpp"
+#include "encounter_file.hpp"
+#include "events.hpp"
+#include "fake_block.hpp"
+#include "fake_steam.hpp"
+#include "steam.hpp"
+#include "utf8.hpp"
+
+#include <spdlog/spdlog.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * Each change to a player's history is appended to encounters.dat as a complete record, and the
+ * index in encounters.idx points to the latest record for each player. The data file is never
+ * rewritten, and a record torn by a crash is cut off when it's opened again, so a crash can at
+ * worst lose the last record.
+ */
+using record = gg::encounter_file::record;
+
+/**
+ * The index is an open-addressing hash table with linear probing, kept at most half full. The
+ * header records how much of the data file it covers, so records appended after the index was
+ * last updated can be found on startup.
+ */
+struct index_header {
+    char magic[8];
+    uint64_t capacity;
+    uint64_t count;
+    uint64_t data_size;
+};
+
+struct index_slot {
+    uint64_t steam_id;
+    uint64_t offset;
+};
+
+static constexpr char index_magic[8] = {'E', 'R', 'G', 'G', 'E', 'I', '0', '1'};
+static constexpr uint64_t initial_capacity = 1024;
+
+static fs::path index_path;
+
+static HANDLE index_file{INVALID_HANDLE_VALUE};
+static HANDLE index_mapping{nullptr};
+static index_header *header{nullptr};
+static index_slot *slots{nullptr};
+
+static gg::encounter_file data_file;
+
+/**
+ * The size of the index, kept separately so the memory page can report it without waiting on the
+ * event thread
+ */
+static atomic<size_t> index_bytes{0};
+static atomic<size_t> indexed_players{0};
+
+/**
+ * Guards the index and the data file. Only the event thread reads and writes them, and the render
+ * thread looks players up in the summaries below instead.
+ */
+static mutex encounters_mutex;
+
+/**
+ * Ping samples taken during the current session with each player, added to their history when
+ * they leave
+ */
+struct session_ping {
+    int64_t sum;
+    unsigned int samples;
+};
+
+static auto session_pings = unordered_map<uint64_t, session_ping>{};
+
+/**
+ * The history of each player in the current session from before they joined, for the render
+ * thread to look up without touching the files
+ */
+static mutex summaries_mutex;
+static auto summaries = unordered_map<uint64_t, gg::encounters::encounter>{};
+
+/**
+ * MurmurHash3 finalizer. SteamIDs only differ in their low bits, so they need to be mixed before
+ * picking a slot.
+ */
+static inline uint64_t mix(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdull;
+    id ^= id >> 33;
+    id *= 0xc4ceb9fe1a85ec53ull;
+    id ^= id >> 33;
+    return id;
+}
+
+static int64_t unix_time() {
+    return chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static void unmap_index() {
+    if (header) UnmapViewOfFile(header);
+    if (index_mapping) CloseHandle(index_mapping);
+    if (index_file != INVALID_HANDLE_VALUE) CloseHandle(index_file);
+    header = nullptr;
+    slots = nullptr;
+    index_mapping = nullptr;
+    index_file = INVALID_HANDLE_VALUE;
+    index_bytes = 0;
+}
+
+/**
+ * Map the index file into memory with room for the given number of slots, creating or growing
+ * the file as needed
+ */
+static bool map_index(uint64_t capacity) {
+    index_file = CreateFileW(index_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                             nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (index_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    auto size = LARGE_INTEGER{.QuadPart = static_cast<LONGLONG>(sizeof(index_header) +
+                                                                capacity * sizeof(index_slot))};
+    index_mapping = CreateFileMappingW(index_file, nullptr, PAGE_READWRITE, size.HighPart,
+                                       size.LowPart, nullptr);
+    if (!index_mapping) {
+        unmap_index();
+        return false;
+    }
+
+    header = static_cast<index_header *>(MapViewOfFile(index_mapping, FILE_MAP_WRITE, 0, 0, 0));
+    if (!header) {
+        unmap_index();
+        return false;
+    }
+    slots = reinterpret_cast<index_slot *>(header + 1);
+    index_bytes = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+static index_slot &find_slot(uint64_t steam_id) {
+    auto mask = header->capacity - 1;
+    for (auto i = mix(steam_id) & mask;; i = (i + 1) & mask) {
+        if (slots[i].steam_id == steam_id || slots[i].steam_id == 0) {
+            return slots[i];
+        }
+    }
+}
+
+static void insert(uint64_t steam_id, uint64_t offset);
+
+/**
+ * Double the size of the index. The existing entries are copied out, then inserted again into
+ * the larger table.
+ */
+static bool grow_index() {
+    auto entries = vector<index_slot>{};
+    for (uint64_t i = 0; i < header->capacity; i++) {
+        if (slots[i].steam_id != 0) {
+            entries.push_back(slots[i]);
+        }
+    }
+
+    auto capacity = header->capacity * 2;
+    auto data_size = header->data_size;
+    unmap_index();
+    if (!map_index(capacity)) {
+        return false;
+    }
+
+    memset(slots, 0, capacity * sizeof(index_slot));
+    header->capacity = capacity;
+    header->count = 0;
+    header->data_size = data_size;
+    for (auto &entry : entries) {
+        insert(entry.steam_id, entry.offset);
+    }
+    return true;
+}
+
+static void insert(uint64_t steam_id, uint64_t offset) {
+    if ((header->count + 1) * 2 > header->capacity && !grow_index()) {
+        SPDLOG_ERROR("Failed to grow {}", index_path.string());
+        return;
+    }
+
+    auto &slot = find_slot(steam_id);
+    if (slot.steam_id == 0) {
+        slot.steam_id = steam_id;
+        header->count++;
+        indexed_players = header->count;
+    }
+    slot.offset = offset;
+}
+
+/**
+ * Index any records in the data file past the given offset. When the index is missing or
+ * doesn't match the data file, this rebuilds it from the start.
+ */
+static void index_records(uint64_t from) {
+    data_file.scan(from, [](const record &r, uint64_t offset) { insert(r.steam_id, offset); });
+    header->data_size = data_file.size();
+}
+
+static optional<record> read_record(uint64_t steam_id) {
+    if (!header) {
+        return nullopt;
+    }
+
+    auto &slot = find_slot(steam_id);
+    if (slot.steam_id == 0) {
+        return nullopt;
+    }
+
+    auto r = data_file.read(slot.offset);
+    if (!r || r->steam_id != steam_id) {
+        return nullopt;
+    }
+    return r;
+}
+
+static void write_record(const record &r) {
+    if (!header) {
+        return;
+    }
+
+    auto offset = data_file.append(r);
+    if (!offset) {
+        return;
+    }
+
+    insert(r.steam_id, *offset);
+    header->data_size = *offset + sizeof(r);
+}
+
+static gg::encounters::encounter to_encounter(const record &r) {
+    auto result = gg::encounters::encounter{
+        .first_seen = chrono::system_clock::time_point{chrono::seconds{r.first_seen}},
+        .last_seen = chrono::system_clock::time_point{chrono::seconds{r.last_seen}},
+        .times_met = r.times_met,
+        .average_ping = nullopt,
+        .blocked = r.blocked != 0,
+        .in_game_name = r.in_game_name,
+        .steam_name = r.steam_name,
+    };
+    if (r.ping_samples > 0) {
+        result.average_ping = static_cast<int>(r.ping_sum / r.ping_samples);
+    }
+    return result;
+}
+
+static void set_summary(uint64_t steam_id, gg::encounters::encounter summary) {
+    auto lock = lock_guard{summaries_mutex};
+    summaries[steam_id] = move(summary);
+}
+
+static void record_join(const gg::events::player_joined &event) {
+    // Players in the fake session aren't worth remembering
+    if (event.steam_id == 0 || gg::fake_steam::is_fake(event.steam_id)) {
+        set_summary(event.steam_id, {});
+        return;
+    }
+
+    session_pings[event.steam_id] = {};
+
+    auto steam_name = string{gg::steam::get_persona_name(event.steam_id)};
+    auto now = unix_time();
+
+    auto lock = lock_guard{encounters_mutex};
+    auto existing = read_record(event.steam_id);
+    set_summary(event.steam_id, existing ? to_encounter(*existing) : gg::encounters::encounter{});
+
+    auto r = existing.value_or(record{.steam_id = event.steam_id, .first_seen = now});
+    r.last_seen = now;
+    r.times_met++;
+    if (!event.get_in_game_name().empty()) {
+        gg::utf8::copy_truncated(r.in_game_name, event.get_in_game_name());
+    }
+    if (!steam_name.empty()) {
+        gg::utf8::copy_truncated(r.steam_name, steam_name);
+    }
+    write_record(r);
+}
+
+static void record_ping(const gg::events::ping_sampled &event) {
+    if (auto session = session_pings.find(event.steam_id); session != session_pings.end()) {
+        session->second.sum += event.ping;
+        session->second.samples++;
+    }
+}
+
+static void record_leave(const gg::events::player_left &event) {
+    {
+        auto lock = lock_guard{summaries_mutex};
+        summaries.erase(event.steam_id);
+    }
+
+    auto session = session_pings.extract(event.steam_id);
+    if (!session) {
+        return;
+    }
+
+    auto blocked = gg::is_player_blocked(CSteamID{event.steam_id});
+
+    auto lock = lock_guard{encounters_mutex};
+    auto r = read_record(event.steam_id);
+    if (!r) {
+        return;
+    }
+
+    r->last_seen = unix_time();
+    r->ping_sum += session.mapped().sum;
+    r->ping_samples += session.mapped().samples;
+    r->blocked = blocked;
+    write_record(*r);
+}
+
+void gg::encounters::open() {
+    index_path = gg::config::mod_folder / "encounters.idx";
+    auto data_path = gg::config::mod_folder / "encounters.dat";
+
+    if (!data_file.open(data_path)) {
+        SPDLOG_ERROR("Failed to open {}", data_path.string());
+        return;
+    }
+
+    auto existing_size = fs::exists(index_path) ? fs::file_size(index_path) : 0;
+    auto existing_capacity = existing_size > sizeof(index_header)
+                                 ? (existing_size - sizeof(index_header)) / sizeof(index_slot)
+                                 : 0;
+    auto capacity = bit_floor(max(existing_capacity, initial_capacity));
+    if (!map_index(capacity)) {
+        SPDLOG_ERROR("Failed to open {}", index_path.string());
+        return;
+    }
+
+    auto data_size = data_file.size();
+    auto valid = memcmp(header->magic, index_magic, sizeof(index_magic)) == 0 &&
+                 header->capacity == existing_capacity && header->capacity == capacity &&
+                 header->count * 2 <= header->capacity && header->data_size <= data_size;
+
+    if (!valid) {
+        SPDLOG_INFO("Rebuilding {}", index_path.string());
+        memcpy(header->magic, index_magic, sizeof(index_magic));
+        header->capacity = capacity;
+        header->count = 0;
+        header->data_size = 0;
+        memset(slots, 0, header->capacity * sizeof(index_slot));
+        index_records(0);
+    } else if (header->data_size < data_size) {
+        // The game closed after a record was written but before the index was updated
+        index_records(header->data_size);
+    }
+
+    indexed_players = header->count;
+    SPDLOG_INFO("Loaded encounter history with {} players", header->count);
+
+    gg::events::subscribe<gg::events::player_joined>(gg::events::delivery::background,
+                                                     record_join);
+    gg::events::subscribe<gg::events::ping_sampled>(gg::events::delivery::background,
+                                                    record_ping);
+    gg::events::subscribe<gg::events::player_left>(gg::events::delivery::background,
+                                                   record_leave);
+}
+
+optional<gg::encounters::encounter> gg::encounters::find(uint64_t steam_id) {
+    auto lock = lock_guard{summaries_mutex};
+    if (auto summary = summaries.find(steam_id); summary != summaries.end()) {
+        return summary->second;
+    }
+    return nullopt;
+}
+
+
+gg::memory::usage gg::encounters::memory_usage() {
+    auto result = memory::usage{
+        .count = indexed_players.load(memory_order_relaxed),
+        .bytes = index_bytes.load(memory_order_relaxed),
+    };
+
+    auto lock = lock_guard{summaries_mutex};
+    for (auto &[_, summary] : summaries) {
+        result.bytes += sizeof(summary) + summary.in_game_name.capacity() +
+                        summary.steam_name.capacity();
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace gg {
+namespace encounters {
+
+/**
+ * What's known about a player from previous sessions
+ */
+struct encounter {
+    std::chrono::system_clock::time_point first_seen;
+    std::chrono::system_clock::time_point last_seen;
+
+    /**
+     * 0 if the player has never been met before
+     */
+    unsigned int times_met{0};
+
+    /**
+     * Average ping over every session with this player, if it was ever measured
+     */
+    std::optional<int> average_ping;
+
+    /**
+     * True if the player was blocked the last time a session with them ended
+     */
+    bool blocked{false};
+
+    std::string in_game_name;
+    std::string steam_name;
+};
+
+/**
+ * Open the encounter history in the mod folder, and start recording players as they join and
+ * leave. Only the index is mapped into memory, so this takes the same time no matter how many
+ * players are in the history.
+ */
+void open();
+
+/**
+ * @returns the history with a player in the current session from before they joined, or nullopt
+ * if it hasn't been loaded yet. Histories are read by the event thread when each player joins, so
+ * this never waits on the files and can be called from the render thread.
+ */
+std::optional<encounter> find(uint64_t steam_id);
+
+/**
+ * @returns how many players are in the history, and the memory used by the mapped index and the
+ * histories of players in the current session
+ */
+memory::usage memory_usage();
+
+}
+}
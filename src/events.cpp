@@ -0,0 +1,68 @@
+#include "events.hpp"
+#include "trace.hpp"
+#include "utf8.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+static vector<void (*)()> render_drains;
+static vector<void (*)()> background_drains;
+
+/**
+ * Incremented for each background event, so the event thread can sleep until there's something
+ * to do
+ */
+static atomic<uint32_t> background_pending{0};
+
+static atomic<size_t> dropped_events{0};
+
+static void drain_background_events() {
+    GG_TRACE_THREAD("events");
+
+    while (true) {
+        background_pending.wait(0, memory_order_acquire);
+        background_pending.exchange(0, memory_order_acq_rel);
+
+        GG_TRACE_ZONE("drain background events");
+        for (auto drain : background_drains) {
+            drain();
+        }
+    }
+}
+
+void gg::events::player_joined::set_in_game_name(string_view name) {
+    gg::utf8::copy_truncated(in_game_name, name);
+}
+
+void gg::events::detail::register_drain(delivery mode, void (*drain)()) {
+    (mode == delivery::render ? render_drains : background_drains).push_back(drain);
+}
+
+void gg::events::detail::notify_background() {
+    background_pending.fetch_add(1, memory_order_release);
+    background_pending.notify_one();
+}
+
+void gg::events::detail::count_dropped() { dropped_events.fetch_add(1, memory_order_relaxed); }
+
+void gg::events::start() {
+    if (!background_drains.empty()) {
+        thread(drain_background_events).detach();
+    }
+}
+
+void gg::events::dispatch() {
+    GG_TRACE_ZONE("events::dispatch");
+
+    for (auto drain : render_drains) {
+        drain();
+    }
+
+    if (auto dropped = dropped_events.exchange(0, memory_order_relaxed)) {
+        SPDLOG_WARN("Dropped {} events because a queue was full", dropped);
+    }
+}
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "spsc_queue.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace gg {
+namespace events {
+
+/**
+ * Events are small copyable structs. Each type has its own preallocated queues, sized by
+ * queue_capacity for how often it's published, so events of one type are delivered in order but
+ * aren't ordered relative to events of other types.
+ */
+struct player_joined {
+    static constexpr size_t queue_capacity = 64;
+
+    uint64_t steam_id{0};
+    int slot{0};
+
+    /**
+     * UTF-8, truncated and null-terminated, since the player's data can't be read once the event
+     * has left the render thread
+     */
+    std::array<char, 64> in_game_name{};
+
+    void set_in_game_name(std::string_view name);
+    std::string_view get_in_game_name() const { return in_game_name.data(); }
+};
+
+struct player_left {
+    static constexpr size_t queue_capacity = 64;
+
+    uint64_t steam_id{0};
+    int slot{0};
+};
+
+struct player_died {
+    static constexpr size_t queue_capacity = 64;
+
+    uint64_t steam_id{0};
+    int slot{0};
+};
+
+/**
+ * Each player's ping is sampled once a second
+ */
+struct ping_sampled {
+    static constexpr size_t queue_capacity = 256;
+
+    uint64_t steam_id{0};
+    int ping{-1};
+};
+
+/**
+ * A player was blocked or unblocked, including when a temporary block expires
+ */
+struct player_blocked {
+    static constexpr size_t queue_capacity = 64;
+
+    uint64_t steam_id{0};
+    bool blocked{false};
+
+    /**
+     * How long the block lasts, or zero if it's permanent
+     */
+    std::chrono::seconds duration{0};
+};
+
+struct disconnected {
+    static constexpr size_t queue_capacity = 8;
+};
+
+/**
+ * Where a subscriber's callback runs. Render subscribers are called from dispatch() once a frame
+ * and can touch the player list and the overlay. Background subscribers are called on the event
+ * thread, for anything slow like file I/O.
+ */
+enum class delivery { render, background };
+
+namespace detail {
+
+void register_drain(delivery mode, void (*drain)());
+void notify_background();
+void count_dropped();
+
+template <typename T>
+struct channel {
+    spsc_queue<T, T::queue_capacity> render_queue;
+    spsc_queue<T, T::queue_capacity> background_queue;
+    std::vector<std::function<void(const T &)>> render_subscribers;
+    std::vector<std::function<void(const T &)>> background_subscribers;
+};
+
+template <typename T>
+channel<T> &get_channel() {
+    static channel<T> instance;
+    return instance;
+}
+
+template <typename T, delivery mode>
+void drain() {
+    auto &channel = get_channel<T>();
+    auto &queue = mode == delivery::render ? channel.render_queue : channel.background_queue;
+    auto &subscribers =
+        mode == delivery::render ? channel.render_subscribers : channel.background_subscribers;
+    while (auto event = queue.pop()) {
+        for (auto &subscriber : subscribers) {
+            subscriber(*event);
+        }
+    }
+}
+
+}
+
+/**
+ * Call a function for every event of a type. Subscribers must be added during initialization,
+ * before start() is called.
+ */
+template <typename T>
+void subscribe(delivery mode, std::function<void(const T &)> callback) {
+    auto &channel = detail::get_channel<T>();
+    if (mode == delivery::render) {
+        if (channel.render_subscribers.empty()) {
+            detail::register_drain(mode, detail::drain<T, delivery::render>);
+        }
+        channel.render_subscribers.push_back(std::move(callback));
+    } else {
+        if (channel.background_subscribers.empty()) {
+            detail::register_drain(mode, detail::drain<T, delivery::background>);
+        }
+        channel.background_subscribers.push_back(std::move(callback));
+    }
+}
+
+/**
+ * Queue an event for its subscribers. Events are only published from the render thread, and this
+ * never blocks or allocates. If a queue is full, the event is dropped and counted.
+ */
+template <typename T>
+void publish(const T &event) {
+    auto &channel = detail::get_channel<T>();
+    if (!channel.render_subscribers.empty() && !channel.render_queue.push(event)) {
+        detail::count_dropped();
+    }
+    if (!channel.background_subscribers.empty()) {
+        if (channel.background_queue.push(event)) {
+            detail::notify_background();
+        } else {
+            detail::count_dropped();
+        }
+    }
+}
+
+/**
+ * Start the thread that calls background subscribers
+ */
+void start();
+
+/**
+ * Call render subscribers for the events published since the last call
+ */
+void dispatch();
+
+}
+}
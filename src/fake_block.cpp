@@ -1,19 +1,76 @@
 #include "fake_block.hpp"
 
+#include "blocklist_journal.hpp"
+#include "blocklists.hpp"
+#include "bloom_filter.hpp"
 #include "config.hpp"
+#include "events.hpp"
+#include "fake_steam.hpp"
+#include "rcu.hpp"
+#include "relationship_cache.hpp"
+#include "steam_id_set.hpp"
+#include "timer_wheel.hpp"
+#include "trace.hpp"
 
 #include <spdlog/spdlog.h>
 #include <steam/isteamfriends.h>
 #include <elden-x/utils/modutils.hpp>
 
-#include <fstream>
-#include <set>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
+namespace fs = std::filesystem;
 
-static auto blocked_players = set<CSteamID>{};
+/**
+ * Immutable copy of the blocklist. Almost every query is for a player who isn't blocked, so an
+ * optional Bloom filter rejects most lookups before the exact set is touched.
+ */
+struct blocklist_snapshot {
+    gg::steam_id_set ids;
+    optional<gg::bloom_filter> filter;
 
-static auto out_stream = ofstream{};
+    blocklist_snapshot() = default;
+
+    explicit blocklist_snapshot(gg::steam_id_set &&set)
+        : ids(move(set)) {
+        if (gg::config::bloom_filter && !ids.empty()) {
+            filter.emplace(ids.ids(), gg::config::bloom_filter_false_positive_rate);
+        }
+    }
+
+    bool contains(uint64_t id) const {
+        return (!filter || filter->may_contain(id)) && ids.contains(id);
+    }
+};
+
+/**
+ * The blocklist is queried from the GetFriendRelationship hook, which can run on any thread, so
+ * it's published as an immutable snapshot that's rebuilt whenever a player is blocked
+ */
+static gg::rcu_ptr<blocklist_snapshot> blocked_players;
+
+static int64_t unix_time() {
+    return chrono::duration_cast<chrono::seconds>(
+               chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+/**
+ * Temporarily blocked players are removed from the blocklist when their block expires, so the
+ * lookup structure doesn't grow forever. The map holds the current expiration time of each
+ * temporary block, and timers that don't match it (because the player was blocked again or
+ * unblocked) are ignored when they fire.
+ */
+static mutex temporary_blocks_mutex;
+static auto temporary_blocks = unordered_map<uint64_t, int64_t>{};
+static auto temporary_block_timers = gg::timer_wheel{unix_time()};
 
 struct steam_friends_vftable {
     void *unk0[5];
@@ -23,13 +80,70 @@ struct steam_friends_vftable {
 
 static steam_friends_vftable steam_friends_patched_vftable;
 
-static EFriendRelationship (*get_friend_relationship)(ISteamFriends *_this, CSteamID steam_id);
+static vector<uint64_t> sort_unique(vector<uint64_t> ids) {
+    ranges::sort(ids);
+    auto [first, last] = ranges::unique(ids);
+    ids.erase(first, last);
+    return ids;
+}
+
+/**
+ * Convert plain text lists in the blocklists folder to the binary format, so they can be mapped
+ * into memory on startup. Lists are only converted again if the text file has been modified.
+ */
+static void convert_text_blocklists(const fs::path &folder) {
+    auto ec = error_code{};
+    for (auto &entry : fs::directory_iterator{folder, ec}) {
+        auto &text_path = entry.path();
+        if (text_path.extension() != ".txt") {
+            continue;
+        }
+
+        auto binary_path = fs::path{text_path}.replace_extension(".bin");
+        if (fs::exists(binary_path, ec) &&
+            fs::last_write_time(binary_path, ec) >= fs::last_write_time(text_path, ec)) {
+            continue;
+        }
+
+        auto start_time = chrono::steady_clock::now();
+
+        auto file = gg::platform::mapped_file{text_path};
+        auto text = file.data();
+        auto ids = sort_unique(gg::blocklists::parse_text({text.data(), text.size()}));
+        if (!gg::blocklists::write_binary(binary_path, ids)) {
+            SPDLOG_ERROR("Failed to write {}", binary_path.string());
+            continue;
+        }
+
+        auto elapsed = chrono::duration<double, milli>{chrono::steady_clock::now() - start_time};
+        SPDLOG_INFO("Converted {} ({} players) to {} in {:.1f}ms", text_path.string(), ids.size(),
+                    binary_path.filename().string(), elapsed.count());
+    }
+}
+
+static EFriendRelationship (*steam_get_friend_relationship)(ISteamFriends *_this,
+                                                           CSteamID steam_id);
 static EFriendRelationship get_friend_relationship_hook(ISteamFriends *_this, CSteamID steam_id) {
+    GG_TRACE_ZONE("GetFriendRelationship hook");
+
     if (gg::is_player_blocked(steam_id)) {
         return k_EFriendRelationshipIgnored;
     }
 
-    return get_friend_relationship(_this, steam_id);
+    // The game and the player list ask about the same few players constantly, so remember
+    // Steam's answer until it tells us something changed
+    if (auto cached = gg::relationship_cache::get(steam_id); cached.has_value()) {
+        return cached.value();
+    }
+
+    // Steam's answer is only cached if nothing invalidated it while Steam was being asked
+    auto generation = gg::relationship_cache::get_generation(steam_id);
+    auto id = steam_id.ConvertToUint64();
+    auto relationship = gg::fake_steam::is_fake(id)
+                            ? gg::fake_steam::get_friend_relationship(id)
+                            : steam_get_friend_relationship(_this, steam_id);
+    gg::relationship_cache::put(steam_id, relationship, generation);
+    return relationship;
 }
 
 void gg::initialize_fake_block() {
@@ -38,43 +152,206 @@ void gg::initialize_fake_block() {
     // blocks only apply while the mod is running.
     auto &vftable = *(steam_friends_vftable **)(void *)SteamFriends();
     steam_friends_patched_vftable = *vftable;
-    get_friend_relationship = steam_friends_patched_vftable.get_friend_relationship;
+    steam_get_friend_relationship = steam_friends_patched_vftable.get_friend_relationship;
     steam_friends_patched_vftable.get_friend_relationship = get_friend_relationship_hook;
     vftable = &steam_friends_patched_vftable;
 
-    // Load already blocked players from the .txt file
-    auto file_path = gg::config::mod_folder / "blocked.txt";
+    gg::relationship_cache::initialize();
+
+    auto start_time = chrono::steady_clock::now();
+
+    // Load players blocked or unblocked in the overlay, including any changes that were still
+    // being written if the game crashed
+    auto snapshot_path = gg::config::mod_folder / "blocked.txt";
+    auto journal_path = gg::config::mod_folder / "blocked.journal";
+    auto own_state = gg::blocklist_journal::recover(snapshot_path, journal_path);
+    if (!own_state.blocked.empty()) {
+        SPDLOG_INFO("Loaded {} blocked players from {}", own_state.blocked.size(),
+                    snapshot_path.string());
+    }
+
+    // Load any shared blocklists, which are mapped directly into memory instead of being parsed
+    auto blocklists_folder = gg::config::mod_folder / "blocklists";
+    convert_text_blocklists(blocklists_folder);
 
-    auto in_stream = ifstream{};
-    in_stream.open(file_path);
-    if (in_stream.is_open()) {
-        string line;
-        while (getline(in_stream, line)) {
-            auto steam_id = strtoull(line.data(), nullptr, 10);
-            blocked_players.insert(steam_id);
+    auto mapped_files = vector<gg::platform::mapped_file>{};
+    auto shared_sources = vector<span<const uint64_t>>{};
+    auto ec = error_code{};
+    for (auto &entry : fs::directory_iterator{blocklists_folder, ec}) {
+        if (entry.path().extension() != ".bin") {
+            continue;
         }
-        in_stream.close();
 
-        if (!blocked_players.empty()) {
-            SPDLOG_INFO("Loaded {} blocked players from {}", blocked_players.size(),
-                        file_path.string());
+        auto &file = mapped_files.emplace_back(entry.path());
+        auto ids = gg::blocklists::read_binary(file);
+        if (!ids) {
+            SPDLOG_WARN("Ignoring invalid blocklist {}", entry.path().string());
+            continue;
+        }
+        if (ids->empty()) {
+            continue;
         }
+
+        SPDLOG_INFO("Loaded {} blocked players from {}", ids->size(), entry.path().string());
+        shared_sources.push_back(*ids);
+    }
+
+    // Players on a shared blocklist stay blocked when their temporary block expires, so only
+    // track temporary blocks for everyone else
+    auto temporary_ids = vector<uint64_t>{};
+    {
+        auto lock = lock_guard{temporary_blocks_mutex};
+        for (auto &[id, expires] : own_state.temporary) {
+            temporary_ids.push_back(id);
+            if (ranges::none_of(shared_sources, [id](auto ids) {
+                    return ranges::binary_search(ids, id);
+                })) {
+                temporary_blocks[id] = expires;
+                temporary_block_timers.add(id, expires);
+            }
+        }
+    }
+    if (!temporary_ids.empty()) {
+        SPDLOG_INFO("Loaded {} temporarily blocked players", temporary_ids.size());
+    }
+
+    auto sources = vector<span<const uint64_t>>{own_state.blocked, temporary_ids};
+    sources.insert(sources.end(), shared_sources.begin(), shared_sources.end());
+
+    // Players unblocked in the overlay override any shared blocklists they're on
+    auto merged_ids = gg::blocklists::merge(sources);
+    auto overridden_ids = vector<uint64_t>{};
+    ranges::set_difference(merged_ids, own_state.unblocked, back_inserter(overridden_ids));
+
+    auto loaded = make_unique<const blocklist_snapshot>(gg::steam_id_set{move(overridden_ids)});
+
+    if (sources.size() > 2) {
+        auto elapsed = chrono::duration<double, milli>{chrono::steady_clock::now() - start_time};
+        SPDLOG_INFO("Merged {} blocked players from {} sources in {:.1f}ms", loaded->ids.size(),
+                    sources.size(), elapsed.count());
+    }
+    if (loaded->filter) {
+        SPDLOG_INFO("Using a {} KiB Bloom filter for blocklist lookups",
+                    loaded->filter->size_bytes() / 1024);
+    }
+    blocked_players.publish(move(loaded));
+
+    gg::blocklist_journal::start(snapshot_path, journal_path, move(own_state));
+}
+
+void gg::block_player(CSteamID steam_id, chrono::seconds duration) {
+    auto id = steam_id.ConvertToUint64();
+    auto expires = duration.count() > 0 ? unix_time() + duration.count() : 0;
+
+    // Blocking a temporarily blocked player again replaces the old expiration time, or makes the
+    // block permanent. The lock is held while the snapshot is updated, so an expiring timer can't
+    // see the player as temporary after they've been blocked permanently.
+    auto lock = unique_lock{temporary_blocks_mutex};
+    auto was_temporary = temporary_blocks.erase(id) > 0;
+
+    // A permanent block, including one from a shared blocklist, isn't shortened by a temporary one
+    if (expires && !was_temporary && blocked_players.read()->ids.contains(id)) {
+        lock.unlock();
+        SPDLOG_INFO("Player {} is already blocked permanently", id);
+        return;
+    }
+
+    if (expires) {
+        temporary_blocks[id] = expires;
+        temporary_block_timers.add(id, expires);
+    }
+
+    auto blocked = blocked_players.update([id](const blocklist_snapshot &current) {
+        return current.ids.contains(id)
+                   ? nullptr
+                   : make_unique<const blocklist_snapshot>(current.ids.with(id));
+    });
+    lock.unlock();
+
+    if (!blocked && !was_temporary) {
+        return;
     }
 
-    out_stream.open(file_path, ios_base::app);
+    gg::events::publish(gg::events::player_blocked{id, true, duration});
+
+    if (expires) {
+        SPDLOG_INFO("Blocking player {} for {} hours", id,
+                    chrono::duration_cast<chrono::hours>(duration).count());
+    } else {
+        SPDLOG_INFO("Blocking player {}", id);
+    }
+    gg::relationship_cache::invalidate(steam_id);
+    gg::blocklist_journal::append(id, true, expires);
+}
+
+void gg::unblock_player(CSteamID steam_id) {
+    auto id = steam_id.ConvertToUint64();
+
+    {
+        auto lock = lock_guard{temporary_blocks_mutex};
+        temporary_blocks.erase(id);
+    }
+
+    auto unblocked = blocked_players.update([id](const blocklist_snapshot &current) {
+        return current.ids.contains(id)
+                   ? make_unique<const blocklist_snapshot>(current.ids.without(id))
+                   : nullptr;
+    });
+    if (!unblocked) {
+        return;
+    }
+
+    SPDLOG_INFO("Unblocking player {}", id);
+    gg::events::publish(gg::events::player_blocked{id, false});
+    gg::relationship_cache::invalidate(steam_id);
+    gg::blocklist_journal::append(id, false);
 }
 
-void gg::block_player(CSteamID steam_id) {
-    if (is_player_blocked(steam_id)) {
+void gg::expire_temporary_blocks() {
+    auto expired_ids = vector<uint64_t>{};
+    {
+        auto lock = lock_guard{temporary_blocks_mutex};
+        temporary_block_timers.advance(unix_time(), [&](uint64_t id, int64_t expires) {
+            auto it = temporary_blocks.find(id);
+            if (it != temporary_blocks.end() && it->second == expires) {
+                temporary_blocks.erase(it);
+                expired_ids.push_back(id);
+            }
+        });
+    }
+
+    if (expired_ids.empty()) {
         return;
     }
 
-    SPDLOG_INFO("Blocking player {}", steam_id.ConvertToUint64());
+    // Expired blocks don't need to be journaled, since the expiration time is already saved
+    blocked_players.update([&](const blocklist_snapshot &current) {
+        return make_unique<const blocklist_snapshot>(current.ids.without(expired_ids));
+    });
 
-    blocked_players.insert(steam_id);
+    for (auto id : expired_ids) {
+        SPDLOG_INFO("Temporary block expired for player {}", id);
+        gg::events::publish(gg::events::player_blocked{id, false});
+        gg::relationship_cache::invalidate(CSteamID{id});
+    }
+}
 
-    out_stream << steam_id.ConvertToUint64() << endl;
-    out_stream.flush();
+EFriendRelationship gg::get_friend_relationship(CSteamID steam_id) {
+    return get_friend_relationship_hook(SteamFriends(), steam_id);
 }
 
-bool gg::is_player_blocked(CSteamID steam_id) { return blocked_players.contains(steam_id); }
+bool gg::is_player_blocked(CSteamID steam_id) {
+    return blocked_players.read()->contains(steam_id.ConvertToUint64());
+}
+
+gg::memory::usage gg::blocklist_memory_usage() {
+    auto blocked = blocked_players.read();
+    auto result = memory::usage{
+        .count = blocked->ids.size(),
+        .bytes = sizeof(blocklist_snapshot) + blocked->ids.size_bytes(),
+    };
+    if (blocked->filter) {
+        result.bytes += blocked->filter->size_bytes();
+    }
+    return result;
+}
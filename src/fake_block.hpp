@@ -1,19 +1,50 @@
 #pragma once
 
+#include "memory.hpp"
+
+#include <steam/isteamfriends.h>
 #include <steam/steamclientpublic.h>
 
+#include <chrono>
+
 namespace gg {
 
 void initialize_fake_block();
 
 /**
- * @returns true if the given player is on the mod's blocklist
+ * Add the given player to the blocklist, and save the change in the background
+ *
+ * @param duration how long to block the player for, or zero to block them permanently
+ */
+void block_player(CSteamID, std::chrono::seconds duration = std::chrono::seconds::zero());
+
+/**
+ * Remove the given player from the blocklist, including shared blocklists, and save the change in
+ * the background
+ */
+void unblock_player(CSteamID);
+
+/**
+ * Unblock any temporarily blocked players whose block has ended. Called regularly from the
+ * player list update.
  */
-void block_player(CSteamID);
+void expire_temporary_blocks();
 
 /**
- * Add the given player to the blocklist, and flush the list to disk
+ * @returns true if the given player is on the mod's blocklist. Safe to call from any thread.
  */
 bool is_player_blocked(CSteamID);
 
+/**
+ * @returns the Steam relationship with the given player, including blocks from the mod. This is
+ * cached, so it's cheap to call every frame.
+ */
+EFriendRelationship get_friend_relationship(CSteamID);
+
+/**
+ * @returns how many players are blocked, and the memory used by the current blocklist snapshot
+ * and its Bloom filter
+ */
+memory::usage blocklist_memory_usage();
+
 }
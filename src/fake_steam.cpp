@@ -0,0 +1,340 @@
+#include "fake_steam.hpp"
+#include "config.hpp"
+
+#include <spdlog/spdlog.h>
+#include <steam/steamclientpublic.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <format>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+static constexpr unsigned int avatar_size = 32;
+static constexpr auto stats_log_interval = chrono::seconds{1};
+
+static const auto fake_names = array{
+    pair{"Tom", "Tom"},
+    pair{"Bingus", "Bingus"},
+    pair{"Guts", "John Steamfriend"},
+    pair{"Melina", "melina_main"},
+    pair{"Patches", "xX_Patches_Xx"},
+    pair{"Blaidd", "Blaidd"},
+    pair{"Ranni", "ranni"},
+    pair{"Rogier", "Rogier"},
+};
+
+struct fake_player {
+    string in_game_name;
+    string persona_name;
+    EFriendRelationship relationship;
+    unsigned int level;
+
+    /**
+     * Where this player starts in the ping trace, so they don't all spike at once
+     */
+    size_t trace_offset;
+
+    array<unsigned char, 3> color;
+};
+
+static atomic<bool> is_active{false};
+
+/**
+ * Every player who has been in the fake session, so their names can still be looked up after
+ * they leave. Entries are never removed, so pointers to their names stay valid.
+ */
+static mutex fake_steam_mutex;
+static unordered_map<uint64_t, fake_player> players;
+static vector<int> ping_trace;
+static chrono::steady_clock::time_point start_time;
+
+/**
+ * The SteamID in each slot of the fake session, or 0 if it's empty. This and the rest of the
+ * session state are only touched on the render thread.
+ */
+static vector<uint64_t> slots;
+static unsigned int ping_trace_revision = -1;
+static vector<gg::session_members::member> members;
+static gg::session_members::tracker tracker;
+static uint32_t next_account_id = 1;
+static double pending_churn = 0;
+static chrono::steady_clock::time_point last_update_time;
+static minstd_rand random_engine;
+
+/**
+ * Call latency is copied out of the config on the render thread, since fake calls are also made
+ * from background threads
+ */
+static atomic<double> call_latency_min{0};
+static atomic<double> call_latency_max{0};
+
+static thread::id render_thread_id;
+static atomic<unsigned int> call_count{0};
+static atomic<int64_t> waited_ns{0};
+static atomic<int64_t> render_thread_waited_ns{0};
+static chrono::steady_clock::time_point last_stats_time;
+
+/**
+ * Block for a random time in the configured range, like a call into a slow Steam client
+ */
+static void simulate_call_latency() {
+    auto min_ms = call_latency_min.load(memory_order_relaxed);
+    auto max_ms = max(min_ms, call_latency_max.load(memory_order_relaxed));
+    call_count.fetch_add(1, memory_order_relaxed);
+    if (max_ms <= 0) {
+        return;
+    }
+
+    thread_local auto engine = minstd_rand{random_device{}()};
+    auto latency = chrono::duration_cast<chrono::nanoseconds>(chrono::duration<double, milli>{
+        uniform_real_distribution{min_ms, max_ms}(engine)});
+
+    // Spin rather than sleep, since sleeps are rounded up to the timer resolution on Windows
+    auto deadline = chrono::steady_clock::now() + latency;
+    while (chrono::steady_clock::now() < deadline) {
+        this_thread::yield();
+    }
+
+    waited_ns.fetch_add(latency.count(), memory_order_relaxed);
+    if (this_thread::get_id() == render_thread_id) {
+        render_thread_waited_ns.fetch_add(latency.count(), memory_order_relaxed);
+    }
+}
+
+static vector<int> parse_ping_trace(string_view text) {
+    auto trace = vector<int>{};
+    while (!text.empty()) {
+        auto end = text.find(',');
+        auto value = text.substr(0, end);
+        text = end == string_view::npos ? string_view{} : text.substr(end + 1);
+
+        auto first = value.find_first_not_of(" \t");
+        if (first == string_view::npos) {
+            continue;
+        }
+        value = value.substr(first);
+
+        int ping;
+        auto [ptr, ec] = from_chars(value.data(), value.data() + value.size(), ping);
+        if (ec != errc{} || ping < 0) {
+            SPDLOG_WARN("Invalid fake_steam ping_trace value \"{}\"", value);
+            continue;
+        }
+        trace.push_back(ping);
+    }
+    return trace;
+}
+
+/**
+ * Make up a new player with a name, avatar color and ping from the config
+ */
+static uint64_t create_player() {
+    auto account_id = next_account_id++;
+    auto steam_id =
+        CSteamID{account_id, k_EUniverseDev, k_EAccountTypeIndividual}.ConvertToUint64();
+
+    auto index = (account_id - 1) % fake_names.size();
+    auto generation = (account_id - 1) / fake_names.size();
+    auto [in_game_name, persona_name] = fake_names[index];
+
+    auto player = fake_player{
+        .in_game_name = generation ? format("{} {}", in_game_name, generation + 1)
+                                   : string{in_game_name},
+        .persona_name = generation ? format("{} {}", persona_name, generation + 1)
+                                   : string{persona_name},
+        .relationship = index == 1   ? k_EFriendRelationshipIgnored
+                        : index == 2 ? k_EFriendRelationshipFriend
+                                     : k_EFriendRelationshipNone,
+        .level = uniform_int_distribution{10u, 200u}(random_engine),
+        .trace_offset = random_engine(),
+        .color = {static_cast<unsigned char>(random_engine()),
+                  static_cast<unsigned char>(random_engine()),
+                  static_cast<unsigned char>(random_engine())},
+    };
+
+    auto lock = lock_guard{fake_steam_mutex};
+    players.emplace(steam_id, move(player));
+    return steam_id;
+}
+
+static const fake_player *find_player(uint64_t steam_id) {
+    auto lock = lock_guard{fake_steam_mutex};
+    auto it = players.find(steam_id);
+    return it == players.end() ? nullptr : &it->second;
+}
+
+static void log_stats(chrono::steady_clock::time_point now) {
+    if (now - last_stats_time < stats_log_interval) {
+        return;
+    }
+
+    auto calls = call_count.exchange(0, memory_order_relaxed);
+    auto waited = chrono::nanoseconds{waited_ns.exchange(0, memory_order_relaxed)};
+    auto render_waited =
+        chrono::nanoseconds{render_thread_waited_ns.exchange(0, memory_order_relaxed)};
+    if (calls > 0) {
+        SPDLOG_DEBUG("Fake Steam: {} calls, {:.1f}ms waiting ({:.1f}ms on the render thread)",
+                     calls, chrono::duration<double, milli>{waited}.count(),
+                     chrono::duration<double, milli>{render_waited}.count());
+    }
+    last_stats_time = now;
+}
+
+bool gg::fake_steam::is_fake(uint64_t steam_id) {
+    return CSteamID{steam_id}.GetEUniverse() == k_EUniverseDev;
+}
+
+bool gg::fake_steam::active() { return is_active.load(memory_order_relaxed); }
+
+void gg::fake_steam::set_active(bool active) {
+    is_active = active;
+    slots.clear();
+    tracker.reset();
+    pending_churn = 0;
+    last_update_time = last_stats_time = chrono::steady_clock::now();
+    render_thread_id = this_thread::get_id();
+    {
+        auto lock = lock_guard{fake_steam_mutex};
+        start_time = last_update_time;
+    }
+
+    SPDLOG_INFO(active ? "Started a fake Steam session" : "Ended the fake Steam session");
+}
+
+span<const gg::session_members::event> gg::fake_steam::update() {
+    if (!active()) {
+        return {};
+    }
+
+    auto now = chrono::steady_clock::now();
+    auto elapsed = chrono::duration<double>{now - last_update_time}.count();
+    last_update_time = now;
+
+    call_latency_min = gg::config::fake_steam_call_latency_min;
+    call_latency_max = gg::config::fake_steam_call_latency_max;
+    if (ping_trace_revision != gg::config::revision) {
+        auto trace = parse_ping_trace(gg::config::fake_steam_ping_trace);
+        auto lock = lock_guard{fake_steam_mutex};
+        ping_trace = move(trace);
+        ping_trace_revision = gg::config::revision;
+    }
+
+    // Fill empty slots or remove players from the end to match the configured player count
+    auto occupied = static_cast<unsigned int>(ranges::count_if(slots, [](auto id) { return id; }));
+    for (size_t slot = 0; occupied < gg::config::fake_steam_players; slot++) {
+        if (slot == slots.size()) {
+            slots.push_back(0);
+        }
+        if (!slots[slot]) {
+            slots[slot] = create_player();
+            occupied++;
+        }
+    }
+    for (auto slot = slots.size(); occupied > gg::config::fake_steam_players; slot--) {
+        if (slots[slot - 1]) {
+            slots[slot - 1] = 0;
+            occupied--;
+        }
+    }
+
+    // Replace random players at the configured rate
+    pending_churn += gg::config::fake_steam_churn * elapsed / 60.0;
+    for (; pending_churn >= 1.0 && occupied > 0; pending_churn -= 1.0) {
+        auto slot = uniform_int_distribution<size_t>{0, slots.size() - 1}(random_engine);
+        while (!slots[slot]) {
+            slot = (slot + 1) % slots.size();
+        }
+        slots[slot] = create_player();
+    }
+    if (occupied == 0) {
+        pending_churn = 0;
+    }
+
+    // Report the changes the same way as a real session
+    members.clear();
+    for (auto steam_id : slots) {
+        members.push_back({nullptr, steam_id});
+    }
+
+    log_stats(now);
+    return tracker.update(members);
+}
+
+string_view gg::fake_steam::get_in_game_name(uint64_t steam_id) {
+    auto player = find_player(steam_id);
+    return player ? string_view{player->in_game_name} : string_view{};
+}
+
+unsigned int gg::fake_steam::get_level(uint64_t steam_id) {
+    auto player = find_player(steam_id);
+    return player ? player->level : 0;
+}
+
+const char *gg::fake_steam::get_persona_name(uint64_t steam_id) {
+    simulate_call_latency();
+    auto player = find_player(steam_id);
+    return player ? player->persona_name.c_str() : "";
+}
+
+bool gg::fake_steam::get_small_avatar(uint64_t steam_id,
+                                      vector<unsigned char> &rgba,
+                                      unsigned int &width,
+                                      unsigned int &height) {
+    simulate_call_latency();
+    auto player = find_player(steam_id);
+    if (!player) {
+        return false;
+    }
+
+    // Diagonal stripes in the player's color, so avatars are easy to tell apart
+    width = height = avatar_size;
+    rgba.resize(avatar_size * avatar_size * 4);
+    for (unsigned int y = 0; y < avatar_size; y++) {
+        for (unsigned int x = 0; x < avatar_size; x++) {
+            auto pixel = rgba.data() + (y * avatar_size + x) * 4;
+            auto shade = ((x + y) / 4) % 2 ? 1.f : .6f;
+            for (int c = 0; c < 3; c++) {
+                pixel[c] = static_cast<unsigned char>(player->color[c] * shade);
+            }
+            pixel[3] = 255;
+        }
+    }
+    return true;
+}
+
+EFriendRelationship gg::fake_steam::get_friend_relationship(uint64_t steam_id) {
+    simulate_call_latency();
+    auto player = find_player(steam_id);
+    return player ? player->relationship : k_EFriendRelationshipNone;
+}
+
+SteamNetConnectionRealTimeStatus_t gg::fake_steam::get_connection_status(uint64_t steam_id) {
+    simulate_call_latency();
+
+    auto status = SteamNetConnectionRealTimeStatus_t{};
+    status.m_nPing = -1;
+
+    auto player = find_player(steam_id);
+    auto lock = lock_guard{fake_steam_mutex};
+    if (!player || ping_trace.empty()) {
+        return status;
+    }
+
+    auto seconds = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - start_time);
+    status.m_nPing = ping_trace[(player->trace_offset + seconds.count()) % ping_trace.size()];
+    status.m_flConnectionQualityLocal = .99f;
+    status.m_flConnectionQualityRemote = .99f;
+    status.m_flOutBytesPerSec = 4000.f;
+    status.m_flInBytesPerSec = 4000.f;
+    status.m_nSendRateBytesPerSecond = 64000;
+    return status;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "session_members.hpp"
+
+#include <steam/isteamfriends.h>
+#include <steam/isteamnetworkingmessages.h>
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gg {
+namespace fake_steam {
+
+/**
+ * @returns true if the SteamID belongs to a player in the fake session. Fake players are in the
+ * dev universe, so they can never be mistaken for real ones.
+ */
+bool is_fake(uint64_t steam_id);
+
+bool active();
+
+/**
+ * Start or end a fake session, configured by the [fake_steam] section of ergg.ini
+ */
+void set_active(bool active);
+
+/**
+ * Move the fake session forward by one frame, adding or replacing players as configured. Fake
+ * players have no PlayerIns, so every event's player is nullptr.
+ *
+ * @returns the players that joined, left or were replaced since the last call, in the same form
+ * as a real session
+ */
+std::span<const session_members::event> update();
+
+std::string_view get_in_game_name(uint64_t steam_id);
+unsigned int get_level(uint64_t steam_id);
+
+/**
+ * Stand-ins for the Steam calls the mod makes. Each one waits for the configured call latency
+ * before it returns, like a slow Steam client would.
+ */
+const char *get_persona_name(uint64_t steam_id);
+bool get_small_avatar(uint64_t steam_id,
+                      std::vector<unsigned char> &rgba,
+                      unsigned int &width,
+                      unsigned int &height);
+EFriendRelationship get_friend_relationship(uint64_t steam_id);
+SteamNetConnectionRealTimeStatus_t get_connection_status(uint64_t steam_id);
+
+}
+}
@@ -0,0 +1,265 @@
+#include "fonts.hpp"
+#include "styles.hpp"
+
+#include "../config.hpp"
+#include "../platform/mapped_file.hpp"
+#include "../renderer/texture.hpp"
+
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <spdlog/spdlog.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <chrono>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+namespace fs = filesystem;
+
+unsigned int gg::gui::font_generation = 0;
+
+/**
+ * System fonts used for glyphs the embedded font doesn't have, such as Cyrillic or CJK player
+ * names. When more than one has a glyph, the first one wins.
+ */
+static constexpr const wchar_t *fallback_font_names[] = {
+    L"segoeui.ttf", // Latin, Greek, Cyrillic
+    L"YuGothM.ttc", // Japanese
+    L"msyh.ttc",    // Simplified Chinese
+    L"malgun.ttf",  // Korean
+};
+
+/**
+ * Glyphs that haven't been drawn for this long are left out the next time the atlas is rebuilt
+ */
+static constexpr auto glyph_lifetime = chrono::minutes{10};
+
+/**
+ * Glyphs that are still on screen are requested every frame, so this is long enough to keep them
+ * when the atlas is trimmed
+ */
+static constexpr auto trimmed_glyph_lifetime = chrono::seconds{5};
+
+/**
+ * Upper bound on glyphs outside of the default range, which keeps the atlas texture small
+ */
+static constexpr size_t max_glyphs = 2048;
+
+/**
+ * The previous atlas texture may still be used by frames in flight, so it's kept around for a few
+ * frames after it's replaced
+ */
+static constexpr int retired_texture_frames = 4;
+
+static optional<span<unsigned char>> embedded_font;
+
+/**
+ * Fallback fonts are mapped into memory instead of read, since they can be tens of MB and only a
+ * few glyphs are used from each. They're only opened once a glyph outside the default range is
+ * requested.
+ */
+static vector<gg::platform::mapped_file> fallback_fonts;
+static bool fallback_fonts_opened = false;
+
+/**
+ * Glyphs outside the default range that have been requested, and when they were last requested
+ */
+static unordered_map<ImWchar, chrono::steady_clock::time_point> used_glyphs;
+
+/**
+ * Glyphs that were requested when the atlas was last built. These may be missing from the atlas
+ * if no font has them, but don't cause another rebuild.
+ */
+static unordered_set<ImWchar> built_glyphs;
+
+static bool atlas_dirty = false;
+
+static ImVector<ImWchar> glyph_ranges;
+
+static shared_ptr<gg::renderer::texture> atlas_texture;
+static deque<pair<shared_ptr<gg::renderer::texture>, int>> retired_textures;
+
+static void open_fallback_fonts() {
+    fallback_fonts_opened = true;
+
+    wchar_t windows_path[MAX_PATH];
+    auto length = GetWindowsDirectoryW(windows_path, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH) {
+        SPDLOG_WARN("Couldn't find the Windows fonts folder");
+        return;
+    }
+
+    auto fonts_folder = fs::path{windows_path} / "Fonts";
+    for (auto name : fallback_font_names) {
+        auto file = gg::platform::mapped_file{fonts_folder / name};
+        if (file.data().empty()) {
+            SPDLOG_DEBUG("Fallback font {} isn't installed", fs::path{name}.string());
+            continue;
+        }
+        fallback_fonts.push_back(move(file));
+    }
+}
+
+static void build_atlas() {
+    auto &io = ImGui::GetIO();
+    io.Fonts->Clear();
+
+    auto builder = ImFontGlyphRangesBuilder{};
+    builder.AddRanges(io.Fonts->GetGlyphRangesDefault());
+    for (auto &[codepoint, _] : used_glyphs) {
+        builder.AddChar(codepoint);
+    }
+    glyph_ranges.clear();
+    builder.BuildRanges(&glyph_ranges);
+
+    auto font_config = ImFontConfig{};
+    font_config.SizePixels = gg::gui::font_size;
+    font_config.PixelSnapH = false;
+    font_config.GlyphRanges = glyph_ranges.Data;
+
+    if (embedded_font) {
+        io.Fonts->AddFontFromMemoryCompressedTTF(embedded_font->data(), embedded_font->size(), 0,
+                                                 &font_config);
+    }
+
+    if (!used_glyphs.empty()) {
+        if (!fallback_fonts_opened) {
+            open_fallback_fonts();
+        }
+
+        // The font data is owned by the mapped files, so ImGui shouldn't copy or free it
+        font_config.FontDataOwnedByAtlas = false;
+        for (auto &file : fallback_fonts) {
+            font_config.MergeMode = io.Fonts->Fonts.Size > 0;
+            auto data = file.data();
+            io.Fonts->AddFontFromMemoryTTF(const_cast<char *>(data.data()),
+                                           static_cast<int>(data.size()), 0, &font_config);
+        }
+    }
+
+    io.Fonts->Build();
+
+    built_glyphs.clear();
+    for (auto &[codepoint, _] : used_glyphs) {
+        built_glyphs.insert(codepoint);
+    }
+}
+
+void gg::gui::initialize_fonts() {
+    embedded_font = gg::config::get_resource("font");
+    build_atlas();
+}
+
+void gg::gui::request_glyphs(string_view text) {
+    auto now = chrono::steady_clock::now();
+    auto expired_swept = false;
+    auto text_end = text.data() + text.size();
+    for (auto p = text.data(); p < text_end;) {
+        if (static_cast<unsigned char>(*p) < 0x80) {
+            p++;
+            continue;
+        }
+
+        unsigned int codepoint;
+        p += ImTextCharFromUtf8(&codepoint, p, text_end);
+        if (codepoint < 0x100 || codepoint > IM_UNICODE_CODEPOINT_MAX) {
+            continue;
+        }
+
+        auto it = used_glyphs.find(codepoint);
+        if (it != used_glyphs.end()) {
+            it->second = now;
+            continue;
+        }
+
+        // When the table is full, make room by dropping glyphs that haven't been drawn in a while.
+        // The table is only swept once per string, not once for each character that doesn't fit.
+        if (used_glyphs.size() >= max_glyphs && !expired_swept) {
+            expired_swept = true;
+            if (erase_if(used_glyphs,
+                         [&](auto &entry) { return now - entry.second > glyph_lifetime; }) > 0) {
+                atlas_dirty = true;
+            }
+        }
+
+        if (used_glyphs.size() < max_glyphs) {
+            used_glyphs.emplace(codepoint, now);
+            if (!built_glyphs.contains(codepoint)) {
+                atlas_dirty = true;
+            }
+        }
+    }
+}
+
+void gg::gui::update_fonts() {
+    auto frame = ImGui::GetFrameCount();
+    while (!retired_textures.empty() &&
+           frame - retired_textures.front().second >= retired_texture_frames) {
+        retired_textures.pop_front();
+    }
+
+    if (!atlas_dirty) {
+        return;
+    }
+    atlas_dirty = false;
+
+    auto now = chrono::steady_clock::now();
+    erase_if(used_glyphs, [&](auto &entry) { return now - entry.second > glyph_lifetime; });
+
+    build_atlas();
+
+    // ImGui 1.91 packs the whole atlas again whenever it's built, so the new atlas is uploaded as
+    // a separate texture rather than updating the old one in place
+    auto &io = ImGui::GetIO();
+    unsigned char *pixels;
+    int width, height;
+    io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    auto texture = gg::renderer::load_texture_from_raw_data(pixels, width, height);
+    if (!texture) {
+        SPDLOG_ERROR("Failed to upload the font atlas");
+        return;
+    }
+
+    io.Fonts->SetTexID(texture->id());
+    io.Fonts->ClearTexData();
+
+    if (atlas_texture) {
+        retired_textures.emplace_back(move(atlas_texture), frame);
+    }
+    atlas_texture = move(texture);
+    font_generation++;
+
+    SPDLOG_DEBUG("Rebuilt font atlas with {} extra glyphs ({}x{})", used_glyphs.size(), width,
+                 height);
+}
+
+gg::memory::usage gg::gui::font_memory() {
+    auto result = memory::usage{.count = used_glyphs.size()};
+    if (atlas_texture) {
+        result.bytes += atlas_texture->memory_size();
+    }
+    for (auto &[texture, _] : retired_textures) {
+        result.bytes += texture->memory_size();
+    }
+    return result;
+}
+
+void gg::gui::trim_fonts() {
+    auto now = chrono::steady_clock::now();
+    auto trimmed = erase_if(used_glyphs, [&](auto &entry) {
+        return now - entry.second > trimmed_glyph_lifetime;
+    });
+    if (trimmed > 0) {
+        atlas_dirty = true;
+    }
+}
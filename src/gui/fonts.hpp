@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../memory.hpp"
+
+#include <string_view>
+
+namespace gg {
+namespace gui {
+
+/**
+ * Incremented whenever the font atlas is rebuilt, so cached text measurements can be discarded
+ */
+extern unsigned int font_generation;
+
+/**
+ * Build the initial font atlas from the embedded font. Only the default Latin glyphs are included
+ * at first, and other glyphs are added as they're requested.
+ */
+void initialize_fonts();
+
+/**
+ * Make sure the glyphs in a UTF-8 string are in the font atlas. Any that aren't are added by the
+ * next call to update_fonts(), so they show up a frame later.
+ */
+void request_glyphs(std::string_view text);
+
+/**
+ * Rebuild the font atlas if any new glyphs were requested. This has to be called before ImGui
+ * starts a new frame, since the fonts can't change while a frame is being drawn.
+ */
+void update_fonts();
+
+/**
+ * @returns how many glyphs outside the default range are in the font atlas, and how much video
+ * memory the atlas textures use
+ */
+memory::usage font_memory();
+
+/**
+ * Leave glyphs that haven't been drawn in the last few seconds out of the atlas, so it's rebuilt
+ * smaller by the next call to update_fonts()
+ */
+void trim_fonts();
+
+}
+}
@@ -0,0 +1,50 @@
+#include "nine_slice.hpp"
+
+using namespace std;
+
+gg::gui::nine_slice_geometry gg::gui::nine_slice(ImVec2 texture_size,
+                                                 ImVec2 pos,
+                                                 ImVec2 size,
+                                                 ImVec2 padding) {
+    auto verts = array{pos, pos + padding, pos + size - padding, pos + size};
+
+    auto uvs = array{ImVec2{0, 0}, padding / texture_size, ImVec2{1, 1} - padding / texture_size,
+                     ImVec2{1, 1}};
+
+    // If the size is too small to fit the padding, shrink the top/bottom or left/right rects to
+    // half of the size
+    if (verts[1].x > verts[2].x) {
+        verts[1].x = verts[2].x = pos.x + size.x / 2.f;
+        uvs[1].x = size.x / 2.f / texture_size.x;
+        uvs[2].x = 1.f - uvs[1].x;
+    }
+
+    if (verts[1].y > verts[2].y) {
+        verts[1].y = verts[2].y = pos.y + size.y / 2.f;
+        uvs[1].y = size.y / 2.f / texture_size.y;
+        uvs[2].y = 1.f - uvs[1].y;
+    }
+
+    auto geometry = nine_slice_geometry{
+        .quads = {},
+        .outer_min = verts[0],
+        .outer_max = verts[3],
+        .inner_min = verts[1],
+        .inner_max = verts[2],
+    };
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (verts[i].x == verts[i + 1].x || verts[j].y == verts[j + 1].y) continue;
+
+            geometry.quads[geometry.count++] = {
+                {verts[i].x, verts[j].y},
+                {verts[i + 1].x, verts[j + 1].y},
+                {uvs[i].x, uvs[j].y},
+                {uvs[i + 1].x, uvs[j + 1].y},
+            };
+        }
+    }
+
+    return geometry;
+}
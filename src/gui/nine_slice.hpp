@@ -0,0 +1,38 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <array>
+#include <cstddef>
+
+namespace gg {
+namespace gui {
+
+struct nine_slice_quad {
+    ImVec2 pos_min;
+    ImVec2 pos_max;
+    ImVec2 uv_min;
+    ImVec2 uv_max;
+};
+
+/**
+ * The quads that make up a 9-slice scaled rect, and the corners of its outer and inner rects
+ */
+struct nine_slice_geometry {
+    std::array<nine_slice_quad, 9> quads;
+    size_t count{0};
+
+    ImVec2 outer_min, outer_max;
+    ImVec2 inner_min, inner_max;
+};
+
+/**
+ * Split a rect into the quads for 9-slice scaling a texture. Quads with no area are left out. This
+ * only does the math, so it doesn't need an ImGui context.
+ *
+ * https://en.wikipedia.org/wiki/9-slice_scaling
+ */
+nine_slice_geometry nine_slice(ImVec2 texture_size, ImVec2 pos, ImVec2 size, ImVec2 padding);
+
+}
+}
@@ -0,0 +1,286 @@
+#include "player_list_columns.hpp"
+#include "styles.hpp"
+#include "text_cache.hpp"
+
+#include "../config.hpp"
+#include "../renderer/texture.hpp"
+#include "../telemetry.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <steam/steamclientpublic.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <string_view>
+
+using namespace std;
+
+static constexpr auto hp_bar_size = ImVec2{64.f, 6.f};
+static constexpr float hp_trend_arrow_size = 6.f;
+
+/**
+ * HP is compared against this long ago to show whether it's rising or falling
+ */
+static constexpr auto hp_trend_window = chrono::seconds{5};
+
+static const auto vip_steam_id = CSteamID{108371544u, k_EUniversePublic, k_EAccountTypeIndividual};
+
+static float text_offset_y() {
+    return ceilf((gg::gui::player_list_row_height - gg::gui::font_size) / 2) * gg::gui::scale;
+}
+
+static ImVec4 vip_color(const gg::player_list_view &view, size_t i) {
+    if (view.steam_ids[i] == vip_steam_id.ConvertToUint64()) {
+        return gg::gui::blue;
+    }
+    return {};
+}
+
+/**
+ * Color friends in green, blocked players in red, and me in blue
+ */
+static ImVec4 relationship_color(const gg::player_list_view &view, size_t i) {
+    auto relationship = view.entries[i]->steam_relationship;
+    if (relationship == k_EFriendRelationshipFriend) {
+        return gg::gui::green;
+    } else if (relationship == k_EFriendRelationshipIgnored) {
+        return gg::gui::red;
+    }
+    return vip_color(view, i);
+}
+
+/**
+ * Render the avatar on the player's Steam profile, if there is one
+ */
+static void render_avatar(const gg::gui::player_list_row &row) {
+    auto avatar_offset_y =
+        ceilf((gg::gui::player_list_row_height - gg::gui::player_list_avatar_size.y) / 2);
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + avatar_offset_y * gg::gui::scale);
+    auto avatar = row.view.avatars[row.i];
+    if (!avatar) {
+        return;
+    }
+
+    // Outline the avatar with the highlight color, if any
+    if (row.color.w) {
+        ImGui::GetForegroundDrawList()->AddRect(
+            ImGui::GetCursorScreenPos() - ImVec2{.5f, .5f} * gg::gui::scale,
+            ImGui::GetCursorScreenPos() +
+                (gg::gui::player_list_avatar_size + ImVec2{.5f, .5f}) * gg::gui::scale,
+            ImGui::GetColorU32(row.color), gg::gui::scale, ImDrawFlags_None, 2.f * gg::gui::scale);
+    }
+
+    ImGui::Image(avatar, gg::gui::player_list_avatar_size * gg::gui::scale);
+}
+
+/**
+ * Render the player's in-game name and/or Steam profile name, falling back to whichever one is
+ * available
+ */
+template <bool show_in_game_name, bool show_steam_name>
+static void render_name(const gg::gui::player_list_row &row) {
+    static const auto open_paren = gg::gui::cached_text{" ("};
+    static const auto close_paren = gg::gui::cached_text{")"};
+
+    auto &entry = row.entry;
+    auto has_in_game_name = show_in_game_name && !entry.in_game_name.empty();
+    auto has_steam_name = show_steam_name && !entry.steam_name.empty();
+    auto &name_color = row.color.w ? row.color : gg::gui::white;
+
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    if (has_in_game_name) {
+        gg::gui::text(entry.in_game_name, name_color);
+        if (has_steam_name) {
+            for (auto text : {&open_paren, &entry.steam_name, &close_paren}) {
+                ImGui::SameLine(0.f, 0.f);
+                gg::gui::text(*text, gg::gui::pale_gold);
+            }
+        }
+    } else if (has_steam_name) {
+        gg::gui::text(entry.steam_name, name_color);
+    } else {
+        ImGui::TextColored(name_color, "Player %d", static_cast<int>(row.i) + 1);
+    }
+}
+
+static void render_level(const gg::gui::player_list_row &row) {
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    gg::gui::text(row.entry.level_text.get(), gg::gui::white);
+}
+
+/**
+ * Render the ping time estimated by Steam
+ */
+static void render_ping(const gg::gui::player_list_row &row) {
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    if (row.entry.steam_ping.value > 0) {
+        auto color =
+            row.entry.steam_ping.value > gg::config::high_ping ? gg::gui::red : gg::gui::white;
+        gg::gui::text(row.entry.ping_text.get(), color);
+    }
+}
+
+static void render_jitter(const gg::gui::player_list_row &row) {
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    if (row.entry.steam_ping.last_sample > 0) {
+        gg::gui::text(row.entry.jitter_text.get(), gg::gui::white);
+    }
+}
+
+/**
+ * Render how long the player has been in the session
+ */
+static void render_session_time(const gg::gui::player_list_row &row) {
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    gg::gui::text(row.entry.session_time_text.get(), gg::gui::white);
+}
+
+/**
+ * Render how many times the player has been met before, in red if they were blocked last time
+ */
+static void render_history(const gg::gui::player_list_row &row) {
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y());
+    if (!row.entry.encounter_badge.empty()) {
+        auto color = row.entry.encounter_blocked ? gg::gui::red : gg::gui::pale_gold;
+        gg::gui::text(row.entry.encounter_badge, color);
+    }
+}
+
+/**
+ * Render a bar showing the player's current HP, with an arrow if it's gone up or down recently
+ */
+static void render_hp(const gg::gui::player_list_row &row) {
+    auto scale = gg::gui::scale;
+    auto offset_y = ceilf((gg::gui::player_list_row_height - hp_bar_size.y) / 2) * scale;
+    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + offset_y);
+
+    auto pos = ImGui::GetCursorScreenPos();
+    auto size = hp_bar_size * scale;
+    ImGui::Dummy(size + ImVec2{(hp_trend_arrow_size + 4.f) * scale, 0.f});
+
+    auto slot = row.view.slots[row.i];
+    auto current = gg::telemetry::latest(slot);
+    if (!current || current->max_hp <= 0) {
+        return;
+    }
+
+    auto draw_list = ImGui::GetWindowDrawList();
+    auto fraction = clamp(static_cast<float>(current->hp) / current->max_hp, 0.f, 1.f);
+    draw_list->AddRectFilled(pos, pos + size, ImGui::GetColorU32({0.f, 0.f, 0.f, .5f}));
+    draw_list->AddRectFilled(pos, pos + ImVec2{size.x * fraction, size.y},
+                             ImGui::GetColorU32(gg::gui::red));
+
+    auto previous = gg::telemetry::ago(slot, hp_trend_window);
+    if (!previous || previous->hp == current->hp) {
+        return;
+    }
+
+    // Point the arrow up in green if HP went up, or down in red if it went down
+    auto arrow_size = hp_trend_arrow_size * scale;
+    auto left = pos.x + size.x + 4.f * scale;
+    auto center_y = pos.y + size.y / 2.f;
+    if (current->hp > previous->hp) {
+        draw_list->AddTriangleFilled({left, center_y + arrow_size / 2.f},
+                                     {left + arrow_size, center_y + arrow_size / 2.f},
+                                     {left + arrow_size / 2.f, center_y - arrow_size / 2.f},
+                                     ImGui::GetColorU32(gg::gui::green));
+    } else {
+        draw_list->AddTriangleFilled({left, center_y - arrow_size / 2.f},
+                                     {left + arrow_size, center_y - arrow_size / 2.f},
+                                     {left + arrow_size / 2.f, center_y + arrow_size / 2.f},
+                                     ImGui::GetColorU32(gg::gui::red));
+    }
+}
+
+struct column {
+    string_view name;
+
+    /**
+     * @returns the function that renders this column with the current config, or nullptr if the
+     * column is hidden
+     */
+    gg::gui::render_cell_fn (*resolve)();
+};
+
+static const auto columns = array{
+    column{"avatar",
+           [] { return gg::config::show_steam_avatar ? render_avatar : nullptr; }},
+    column{"name",
+           []() -> gg::gui::render_cell_fn {
+               if (gg::config::show_in_game_name) {
+                   return gg::config::show_steam_name ? render_name<true, true>
+                                                      : render_name<true, false>;
+               }
+               return gg::config::show_steam_name ? render_name<false, true>
+                                                  : render_name<false, false>;
+           }},
+    column{"level", [] { return gg::config::show_level ? render_level : nullptr; }},
+    column{"ping", [] { return gg::config::show_ping ? render_ping : nullptr; }},
+    column{"jitter", [] { return render_jitter; }},
+    column{"time", [] { return render_session_time; }},
+    column{"hp", [] { return render_hp; }},
+    column{"history", [] { return render_history; }},
+};
+
+/**
+ * Column names in ergg.ini are case insensitive, like the other names in it
+ */
+static bool equals_ignore_case(string_view a, string_view b) {
+    return ranges::equal(a, b, [](unsigned char x, unsigned char y) {
+        return tolower(x) == tolower(y);
+    });
+}
+
+static gg::gui::player_list_layout build_layout() {
+    auto layout = gg::gui::player_list_layout{};
+    layout.highlight_color =
+        gg::config::show_steam_relationship ? relationship_color : vip_color;
+
+    // Columns are separated by commas, with any amount of whitespace
+    auto names = string_view{gg::config::player_list_columns};
+    while (!names.empty()) {
+        auto end = names.find(',');
+        auto name = names.substr(0, end);
+        names = end == string_view::npos ? string_view{} : names.substr(end + 1);
+
+        auto first = name.find_first_not_of(" \t");
+        if (first == string_view::npos) {
+            continue;
+        }
+        name = name.substr(first, name.find_last_not_of(" \t") - first + 1);
+
+        auto it = ranges::find_if(
+            columns, [&](const column &column) { return equals_ignore_case(column.name, name); });
+        if (it == columns.end()) {
+            SPDLOG_WARN("Unknown player list column \"{}\"", name);
+            continue;
+        }
+
+        if (auto render = it->resolve()) {
+            layout.cells.push_back(render);
+        }
+    }
+
+    // Always show something to identify each player
+    if (layout.cells.empty()) {
+        layout.cells.push_back(columns[1].resolve());
+    }
+
+    return layout;
+}
+
+const gg::gui::player_list_layout &gg::gui::get_player_list_layout() {
+    static auto layout = player_list_layout{};
+    static auto layout_revision = ~0u;
+
+    if (layout_revision != gg::config::revision) {
+        layout = build_layout();
+        layout_revision = gg::config::revision;
+    }
+
+    return layout;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../player_list.hpp"
+
+#include <imgui.h>
+
+#include <vector>
+
+namespace gg {
+namespace gui {
+
+/**
+ * One row of the player list, drawn from index i of the player list view
+ */
+struct player_list_row {
+    const player_list_view &view;
+    size_t i;
+    const player_list_entry &entry;
+
+    /**
+     * Color to highlight the player with, or transparent for none
+     */
+    ImVec4 color;
+};
+
+using render_cell_fn = void (*)(const player_list_row &);
+
+/**
+ * The player list columns chosen in the config, resolved into one render function per cell. Every
+ * config check happens when the layout is built, so rendering a row is just a call per column.
+ */
+struct player_list_layout {
+    std::vector<render_cell_fn> cells;
+    ImVec4 (*highlight_color)(const player_list_view &, size_t);
+};
+
+/**
+ * @returns the current player list layout, rebuilt only when the config has changed
+ */
+const player_list_layout &get_player_list_layout();
+
+}
+}
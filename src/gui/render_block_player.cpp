@@ -6,14 +6,17 @@
 #include "styles.hpp"
 #include "utils.hpp"
 
+#include "../auto_block.hpp"
 #include "../config.hpp"
 #include "../fake_block.hpp"
+#include "../input.hpp"
 #include "../player_list.hpp"
 #include "../renderer/texture.hpp"
 
 #include <imgui.h>
 
 #include <array>
+#include <chrono>
 #include <memory>
 
 using namespace std;
@@ -25,15 +28,35 @@ static const auto number_key_files =
 static auto number_key_textures =
     array<shared_ptr<gg::renderer::texture>, number_key_files.size()>{};
 
+struct block_duration {
+    const char *label;
+    chrono::seconds duration;
+};
+
+/**
+ * Durations that can be cycled through while in block mode. Temporary blocks are useful for
+ * players who are just annoying, rather than cheating.
+ */
+static const auto block_durations = array{
+    block_duration{"Block permanently", chrono::seconds::zero()},
+    block_duration{"Block for 1 hour", chrono::hours{1}},
+    block_duration{"Block for 24 hours", chrono::hours{24}},
+    block_duration{"Block for 7 days", chrono::hours{24 * 7}},
+};
+
 void gg::gui::initialize_block_player() {
     ranges::transform(number_key_files, number_key_textures.begin(),
                       [](auto file) { return renderer::load_texture_from_resource(file); });
 
     initialize_fake_block();
+    auto_block::start();
 }
 
 void gg::gui::render_block_player(bool &is_open, const ImVec2 &window_pos, int player_count) {
     static int last_player_count = 0;
+    static size_t duration_index = 0;
+
+    auto_block::apply_actions();
 
     int effective_player_count = player_count;
     if (effective_player_count > number_key_textures.size()) {
@@ -43,29 +66,34 @@ void gg::gui::render_block_player(bool &is_open, const ImVec2 &window_pos, int p
     // Enter block mode when the configured key is pressed
     if (ImGui::IsKeyPressed(gg::config::block_player_key)) {
         is_open = !is_open;
+        duration_index = 0;
     }
 
     if (is_open) {
-        // When in block mode, a number key can be pressed to block a single player
-        int slot = 0;
-        for (auto &entry : player_list_entries) {
-            if (!entry.has_value()) {
-                continue;
-            }
+        if (ImGui::IsKeyPressed(gg::config::block_duration_key)) {
+            duration_index = (duration_index + 1) % block_durations.size();
+        }
 
+        // When in block mode, a number key can be pressed to block or unblock a single player
+        auto &view = player_list;
+        for (int slot = 0; slot < view.size() && slot < number_key_textures.size(); slot++) {
             if ((ImGui::IsKeyPressed(static_cast<ImGuiKey>(ImGuiKey_1 + slot))) ||
                 (ImGui::IsKeyPressed(static_cast<ImGuiKey>(ImGuiKey_Keypad1 + slot)))) {
-                if (entry->player && entry->player->session_holder.network_session) {
-                    block_player(entry->player->session_holder.network_session->steam_id);
+                // Pick the same player again to undo a block
+                if (view.steam_ids[slot]) {
+                    auto steam_id = CSteamID{view.steam_ids[slot]};
+                    if (is_player_blocked(steam_id)) {
+                        unblock_player(steam_id);
+                    } else {
+                        block_player(steam_id, block_durations[duration_index].duration);
+                    }
+                    gg::input::log_latency(static_cast<ImGuiKey>(ImGuiKey_1 + slot), "Blocked");
+                    gg::input::log_latency(static_cast<ImGuiKey>(ImGuiKey_Keypad1 + slot),
+                                           "Blocked");
                 }
                 is_open = false;
                 break;
             }
-
-            slot++;
-            if (slot >= number_key_textures.size()) {
-                break;
-            }
         }
     }
 
@@ -91,5 +119,12 @@ void gg::gui::render_block_player(bool &is_open, const ImVec2 &window_pos, int p
                                                      {1.f, 1.f}, color);
             pos.y += gg::gui::player_list_row_height;
         }
+
+        // Show which block duration is selected below the key icons
+        if (effective_player_count > 0) {
+            auto label = block_durations[duration_index].label;
+            auto label_pos = ImVec2{window_pos.x - ImGui::CalcTextSize(label).x - 8.f, pos.y};
+            ImGui::GetForegroundDrawList()->AddText(label_pos, color, label);
+        }
     }
 }
@@ -1,8 +1,11 @@
 #include "render_disconnect.hpp"
 #include "styles.hpp"
+#include "text_cache.hpp"
 #include "utils.hpp"
 
 #include "../config.hpp"
+#include "../events.hpp"
+#include "../input.hpp"
 #include "../renderer/texture.hpp"
 
 #include <imgui.h>
@@ -14,7 +17,7 @@
 
 using namespace std;
 
-static string prompt = "Press again to disconnect, or ESC to cancel";
+static const gg::gui::cached_text prompt = "Press again to disconnect, or ESC to cancel";
 
 shared_ptr<gg::renderer::texture> background_texture;
 
@@ -36,6 +39,8 @@ void gg::gui::render_disconnect(bool &is_open, const ImVec2 &windowpos, const Im
                     session_man->end_session(session);
                 }
             }
+            gg::events::publish(gg::events::disconnected{});
+            gg::input::log_latency(gg::config::disconnect_key, "Disconnected");
         }
 
         is_open = !is_open;
@@ -53,11 +58,12 @@ void gg::gui::render_disconnect(bool &is_open, const ImVec2 &windowpos, const Im
         auto text_color = white;
         text_color.w = fade_in_out.alpha;
 
-        auto text_begin = prompt.data();
-        auto text_end = prompt.data() + prompt.size();
+        auto &text = prompt.str();
+        auto text_begin = text.data();
+        auto text_end = text.data() + text.size();
         auto wrap_width = windowsize.x;
 
-        auto size = ImGui::CalcTextSize(text_begin, text_end, false, wrap_width);
+        auto size = prompt.size(wrap_width);
 
         auto padding = ImVec2{120.f, 24.f};
 
@@ -2,10 +2,13 @@
 #include "styles.hpp"
 #include "utils.hpp"
 
+#include "../events.hpp"
 #include "../logs.hpp"
 #include "../renderer/texture.hpp"
+#include "../steam.hpp"
 
 #include <imgui.h>
+#include <spdlog/spdlog.h>
 
 using namespace std;
 
@@ -13,6 +16,21 @@ static shared_ptr<gg::renderer::texture> background_texture;
 
 void gg::gui::initialize_logs() {
     background_texture = renderer::load_texture_from_resource("MENU_FL_d0");
+
+    // Log players coming and going, so they can be looked back on after they've left the list
+    using namespace gg::events;
+    subscribe<player_joined>(delivery::render, [](const player_joined &event) {
+        SPDLOG_INFO("{} ({}) joined", event.get_in_game_name(),
+                    steam::get_persona_name(event.steam_id));
+    });
+    subscribe<player_left>(delivery::render, [](const player_left &event) {
+        SPDLOG_INFO("{} left", steam::get_persona_name(event.steam_id));
+    });
+    subscribe<player_died>(delivery::render, [](const player_died &event) {
+        SPDLOG_INFO("{} died", steam::get_persona_name(event.steam_id));
+    });
+    subscribe<disconnected>(delivery::render,
+                            [](const disconnected &) { SPDLOG_INFO("Disconnected"); });
 }
 
 void gg::gui::render_logs(ImVec2 pos, bool is_open) {
@@ -0,0 +1,101 @@
+#include "render_memory.hpp"
+#include "styles.hpp"
+#include "utils.hpp"
+
+#include "../config.hpp"
+#include "../memory.hpp"
+#include "../renderer/texture.hpp"
+
+#include <imgui.h>
+
+#include <memory>
+
+using namespace std;
+
+static shared_ptr<gg::renderer::texture> background_texture;
+
+/**
+ * Draw a row with a label and the memory used for it
+ */
+static void render_usage(const char *label, const gg::memory::usage &usage, const char *unit) {
+    ImGui::TextColored(gg::gui::white, "%s", label);
+    ImGui::SameLine(160.f * gg::gui::scale);
+    ImGui::TextColored(gg::gui::white, "%s", gg::memory::format_bytes(usage.bytes).c_str());
+    ImGui::SameLine(260.f * gg::gui::scale);
+    ImGui::TextColored(gg::gui::pale_gold, "%zu %s", usage.count, unit);
+}
+
+/**
+ * Draw a total and its budget, in red if it's over
+ */
+static void render_total(const char *label, size_t bytes, unsigned int budget_mb) {
+    auto color = bytes > size_t{budget_mb} * 1024 * 1024 ? gg::gui::red : gg::gui::pale_gold;
+    ImGui::TextColored(color, "%s %s / %u MB", label, gg::memory::format_bytes(bytes).c_str(),
+                       budget_mb);
+}
+
+void gg::gui::initialize_memory() {
+    background_texture = renderer::load_texture_from_resource("MENU_FL_Equip_waku");
+}
+
+void gg::gui::render_memory(bool is_open) {
+    static fade_in_out fade_in_out;
+    static bool was_open = false;
+
+    // Opening the page also writes the numbers to the log, so they can be compared later
+    if (is_open && !was_open) {
+        memory::log(memory::measure());
+    }
+    was_open = is_open;
+
+    if (!fade_in_out.animate(is_open)) {
+        return;
+    }
+
+    auto report = memory::measure();
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, {0, 0});
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2{8, 4} * scale);
+    ImGui::PushStyleVar(ImGuiStyleVar_Alpha, fade_in_out.alpha);
+
+    auto viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(viewport->WorkPos + ImVec2{80.f, 80.f} * scale, ImGuiCond_Always);
+    ImGui::SetNextWindowBgAlpha(0);
+    ImGui::Begin("memory", nullptr,
+                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                     ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs);
+
+    render_total("VRAM", report.vram_bytes(), config::vram_budget_mb);
+    render_usage("Textures", report.textures, "textures");
+    render_usage("  Font atlas", report.font_atlas, "extra glyphs");
+    render_usage("  Avatars", report.avatars, "avatars");
+    ImGui::TextColored(white, "Descriptors");
+    ImGui::SameLine(160.f * scale);
+    ImGui::TextColored(white, "%u / %u", report.descriptors_used, report.descriptors_capacity);
+
+    ImGui::Spacing();
+
+    render_total("RAM", report.ram_bytes(), config::ram_budget_mb);
+    render_usage("ImGui heap", report.imgui_heap, "allocations");
+    render_usage("Logs", report.logs, "messages");
+    render_usage("Player list", report.player_list, "players");
+    render_usage("Telemetry", report.telemetry, "slots");
+    render_usage("Blocklist", report.blocklist, "players");
+    render_usage("Encounters", report.encounters, "players");
+    render_usage("Relationships", report.relationship_cache, "cached");
+
+    auto windowpos = ImGui::GetWindowPos();
+    auto windowsize = ImGui::GetWindowSize();
+
+    ImGui::End();
+
+    if (background_texture) {
+        auto padding = ImVec2{32, 28} * scale;
+        render_nine_slice(ImGui::GetBackgroundDrawList(), background_texture->id(),
+                          background_texture->size(), windowpos - padding,
+                          windowsize + padding * 2.f, {56.f, 56.f}, .8f * fade_in_out.alpha);
+    }
+
+    ImGui::PopStyleVar(4);
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <imgui.h>
+
+namespace gg {
+namespace gui {
+
+void initialize_memory();
+void render_memory(bool is_open);
+
+}
+}
@@ -1,54 +1,59 @@
 #include "render_overlay.hpp"
+#include "fonts.hpp"
 #include "render_logs.hpp"
+#include "render_memory.hpp"
 #include "render_player_list.hpp"
+#include "render_settings.hpp"
 #include "styles.hpp"
 
 #include "../config.hpp"
+#include "../events.hpp"
+#include "../input.hpp"
+#include "../memory.hpp"
+#include "../trace.hpp"
 
 #include <spdlog/spdlog.h>
 
 #include <backends/imgui_impl_dx12.h>
 #include <imgui.h>
-#include <misc/freetype/imgui_freetype.h>
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
-#include <array>
+#include <chrono>
 #include <cmath>
-#include <filesystem>
-#include <fstream>
-#include <vector>
 
 using namespace std;
-namespace fs = filesystem;
 
 float gg::gui::scale = 1.f;
 
-static void load_font() {
-    auto resource = gg::config::get_resource("font");
-    if (resource.has_value()) {
-        auto font_data = resource.value();
-
-        auto font_config = ImFontConfig{};
-        font_config.SizePixels = gg::gui::font_size;
-        font_config.PixelSnapH = false;
-
-        auto &io = ImGui::GetIO();
-        io.Fonts->AddFontFromMemoryCompressedTTF(font_data.data(), font_data.size(), 0,
-                                                 &font_config);
-        io.Fonts->Build();
-    }
-}
-
 void gg::gui::initialize_overlay() {
     ImGui::GetStyle().WindowBorderSize = 0;
-    load_font();
+    gg::gui::initialize_fonts();
     gg::gui::initialize_player_list();
     gg::gui::initialize_logs();
+    gg::gui::initialize_settings();
+    gg::gui::initialize_memory();
+
+    // Every subscriber has been added by now
+    gg::events::start();
+}
+
+void gg::gui::update_overlay() {
+    GG_TRACE_ZONE("update_overlay");
+    gg::input::update();
+    gg::events::dispatch();
+    gg::gui::update_fonts();
+    gg::memory::update();
+    gg::trace::update();
 }
 
 void gg::gui::render_overlay() {
+    GG_TRACE_ZONE("render_overlay");
+
+    // Pick up changes to ergg.ini before anything reads the config this frame
+    gg::config::update();
+
     auto &io = ImGui::GetIO();
     auto viewport = ImGui::GetMainViewport();
 
@@ -60,6 +65,8 @@ void gg::gui::render_overlay() {
 
     static bool is_player_list_open = true;
     static bool is_logs_open = false;
+    static bool is_settings_open = false;
+    static bool is_memory_open = false;
     static bool player_list_priority = false;
 
     auto show_player_list = is_player_list_open && (!is_logs_open || player_list_priority);
@@ -79,4 +86,23 @@ void gg::gui::render_overlay() {
             player_list_priority = false;
         }
     }
+
+    gg::gui::render_settings(is_settings_open);
+    if (ImGui::IsKeyPressed(gg::config::toggle_settings_key)) {
+        is_settings_open = !is_settings_open;
+    }
+
+    gg::gui::render_memory(is_memory_open && gg::config::debug);
+    if (gg::config::debug && ImGui::IsKeyPressed(gg::config::toggle_memory_key)) {
+        is_memory_open = !is_memory_open;
+    }
+
+    if (ImGui::IsKeyPressed(gg::config::capture_trace_key)) {
+        gg::trace::start(chrono::seconds{gg::config::trace_seconds},
+                         gg::config::mod_folder / "traces");
+    }
+
+    // The settings panel is the only part of the overlay that uses the mouse or keys other than
+    // hotkeys
+    gg::input::set_interactive(is_settings_open);
 }
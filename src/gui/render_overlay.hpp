@@ -4,6 +4,12 @@ namespace gg {
 namespace gui {
 
 void initialize_overlay();
+
+/**
+ * Called before each frame, for changes that can't be made while a frame is being drawn
+ */
+void update_overlay();
+
 void render_overlay();
 
 }
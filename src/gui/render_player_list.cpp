@@ -1,5 +1,6 @@
 #include <steam/steamclientpublic.h>
 
+#include "player_list_columns.hpp"
 #include "render_block_player.hpp"
 #include "render_disconnect.hpp"
 #include "render_player_list.hpp"
@@ -7,6 +8,8 @@
 #include "utils.hpp"
 
 #include "../config.hpp"
+#include "../encounters.hpp"
+#include "../network_monitor.hpp"
 #include "../player_list.hpp"
 #include "../renderer/texture.hpp"
 
@@ -14,97 +17,48 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 using namespace std;
 
-static const auto vip_steam_id = CSteamID{108371544u, k_EUniversePublic, k_EAccountTypeIndividual};
-
 static shared_ptr<gg::renderer::texture> container_background_texture;
 static shared_ptr<gg::renderer::texture> entry_background_texture;
 static shared_ptr<gg::renderer::texture> menu_fe_namebase;
 
+static constexpr float network_details_row_height = 20;
+
 /**
  * Draw saved information about a player in the game session to an ImGui table row
+ *
+ * @returns the top of the row, relative to the window
  */
-static void render_player_list_entry(const gg::player_list_entry &entry, int index) {
-    auto text_offset_y = ceilf((gg::gui::player_list_row_height - gg::gui::font_size) / 2);
-    auto avatar_offset_y =
-        ceilf((gg::gui::player_list_row_height - gg::gui::player_list_avatar_size.y) / 2);
-
-    // Color friends in green, blocked players in red, and me in blue
-    auto color = ImVec4{};
-    if (gg::config::show_steam_relationship &&
-        entry.steam_relationship == k_EFriendRelationshipFriend) {
-        color = gg::gui::green;
-    } else if (gg::config::show_steam_relationship &&
-               entry.steam_relationship == k_EFriendRelationshipIgnored) {
-        color = gg::gui::red;
-    } else if (entry.player && entry.player->session_holder.network_session &&
-               entry.player->session_holder.network_session->steam_id == vip_steam_id) {
-        color = gg::gui::blue;
-    }
+static float render_player_list_entry(const gg::gui::player_list_layout &layout,
+                                      const gg::player_list_view &view,
+                                      size_t i) {
+    auto row = gg::gui::player_list_row{view, i, *view.entries[i], layout.highlight_color(view, i)};
 
     ImGui::TableNextRow(ImGuiTableRowFlags_None, gg::gui::player_list_row_height * gg::gui::scale);
-
-    // Column 1 - render the avatar on the player's Steam profile, if there is one
-    if (gg::config::show_steam_avatar) {
+    auto top = 0.f;
+    for (size_t cell = 0; cell < layout.cells.size(); cell++) {
         ImGui::TableNextColumn();
-        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + avatar_offset_y * gg::gui::scale);
-        if (entry.steam_avatar) {
-            // Outline the avatar with the highlight color, if any
-            if (color.w) {
-                ImGui::GetForegroundDrawList()->AddRect(
-                    ImGui::GetCursorScreenPos() - ImVec2{.5f, .5f} * gg::gui::scale,
-                    ImGui::GetCursorScreenPos() +
-                        (gg::gui::player_list_avatar_size + ImVec2{.5f, .5f}) * gg::gui::scale,
-                    ImGui::GetColorU32(color), gg::gui::scale, ImDrawFlags_None,
-                    2.f * gg::gui::scale);
-            }
-
-            ImGui::Image(entry.steam_avatar->id(),
-                         gg::gui::player_list_avatar_size * gg::gui::scale);
+        if (cell == 0) {
+            top = ImGui::GetCursorScreenPos().y - ImGui::GetWindowPos().y;
         }
+        layout.cells[cell](row);
     }
+    return top;
+}
 
-    // Column 2 - render the player's in-game name and Steam profile name
-    auto show_in_game_name = gg::config::show_in_game_name && !entry.in_game_name.empty();
-    auto show_steam_name = gg::config::show_steam_name && !entry.steam_name.empty();
-    auto &name_color = color.w ? color : gg::gui::white;
-
+/**
+ * Add an empty row under a player for their network details, which are drawn after the table so
+ * they can span every column
+ *
+ * @returns the top of the row, relative to the window
+ */
+static float render_network_details_row() {
+    ImGui::TableNextRow(ImGuiTableRowFlags_None, network_details_row_height * gg::gui::scale);
     ImGui::TableNextColumn();
-    ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y * gg::gui::scale);
-    if (show_in_game_name) {
-        ImGui::TextColored(name_color, "%s", entry.in_game_name.data());
-        if (show_steam_name) {
-            ImGui::SameLine(0.f, 0.f);
-            ImGui::TextColored(gg::gui::pale_gold, " (%s)", entry.steam_name.data());
-        }
-    } else if (show_steam_name) {
-        ImGui::TextColored(name_color, "%s", entry.steam_name.data());
-    } else {
-        ImGui::TextColored(name_color, "Player %d", index + 1);
-    }
-
-    // Column 3 - rune level
-    if (gg::config::show_level) {
-        ImGui::TableNextColumn();
-        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y * gg::gui::scale);
-        if (entry.player) {
-            ImGui::TextColored(gg::gui::white, "Level %d", entry.player->game_data->rune_level);
-        } else {
-            ImGui::TextColored(gg::gui::white, "Level 90");
-        }
-    }
-
-    // Column 4 - ping time estimated by Steam
-    if (gg::config::show_ping) {
-        ImGui::TableNextColumn();
-        ImGui::SetCursorPosY(ImGui::GetCursorPosY() + text_offset_y * gg::gui::scale);
-        if (entry.steam_ping > 0) {
-            auto color = entry.steam_ping > gg::config::high_ping ? gg::gui::red : gg::gui::white;
-            ImGui::TextColored(color, "%dms", entry.steam_ping);
-        }
-    }
+    return ImGui::GetCursorScreenPos().y - ImGui::GetWindowPos().y;
 }
 
 void gg::gui::initialize_player_list() {
@@ -114,20 +68,29 @@ void gg::gui::initialize_player_list() {
 
     initialize_block_player();
     initialize_disconnect();
+    network_monitor::start();
+    encounters::open();
 }
 
 void gg::gui::render_player_list(ImVec2 pos, bool is_open) {
     static fade_in_out fade_in_out;
     static bool is_block_player_open = false;
     static bool is_disconnect_open = false;
+    static bool show_network_details = false;
+    static vector<float> row_tops;
+    static vector<pair<size_t, float>> details_tops;
+
+    if (ImGui::IsKeyPressed(gg::config::toggle_network_details_key)) {
+        show_network_details = !show_network_details;
+    }
 
     update_player_list();
 
-    bool can_show_player_list =
-        ranges::any_of(player_list_entries, [](auto &entry) { return entry.has_value(); });
+    auto &view = player_list;
+    auto player_count = static_cast<int>(view.size());
 
     // Skip rendering the overlay if there are no entries, so we don't ever show a blank rectangle
-    if (!fade_in_out.animate(can_show_player_list && is_open)) {
+    if (!fade_in_out.animate(!view.empty() && is_open)) {
         is_block_player_open = false;
         is_disconnect_open = false;
         return;
@@ -145,17 +108,19 @@ void gg::gui::render_player_list(ImVec2 pos, bool is_open) {
                      ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
                      ImGuiWindowFlags_NoNav);
 
-    int column_count = 1;
-    if (config::show_steam_avatar) column_count++;
-    if (config::show_ping) column_count++;
-    if (config::show_level) column_count++;
-
-    ImGui::BeginTable("player_list_table", column_count);
-    int player_count = 0;
-    for (auto &entry : player_list_entries) {
-        if (entry.has_value()) {
-            player_count++;
-            render_player_list_entry(entry.value(), player_count);
+    auto &layout = get_player_list_layout();
+
+    ImGui::BeginTable("player_list_table", static_cast<int>(layout.cells.size()));
+
+    // Network details are hidden while blocking, so the number keys line up with the players
+    auto with_details = show_network_details && !is_block_player_open;
+
+    row_tops.clear();
+    details_tops.clear();
+    for (size_t i = 0; i < view.size(); i++) {
+        row_tops.push_back(render_player_list_entry(layout, view, i));
+        if (with_details && !view.entries[i]->network_details.empty()) {
+            details_tops.emplace_back(i, render_network_details_row());
         }
     }
     ImGui::EndTable();
@@ -177,34 +142,38 @@ void gg::gui::render_player_list(ImVec2 pos, bool is_open) {
     // Draw a transprent texture behind each entry in the list
     if (menu_fe_namebase) {
         auto padding = ImVec2{16.f, 0.f} * scale;
-        auto pos = windowpos - padding;
         auto size = ImVec2{windowsize.x, player_list_row_height * scale} + padding * 2.f;
-        for (int i = 0; i < player_count; i++) {
+        for (auto top : row_tops) {
+            auto pos = windowpos + ImVec2{0.f, top} - padding;
             render_nine_slice(ImGui::GetBackgroundDrawList(), menu_fe_namebase->id(),
                               menu_fe_namebase->size(), pos, size, {36.f, 0.f}, .8f);
-
-            pos.y += player_list_row_height * scale;
         }
     }
 
     // Cross out dead players
     if (entry_background_texture) {
-        auto pos = windowpos - ImVec2{10.f, 8.f} * scale;
         auto size =
             ImVec2{windowsize.x, player_list_row_height * scale} + ImVec2{12.f, 15.f} * scale;
-        for (auto entry : player_list_entries) {
-            if (entry.has_value()) {
-                if (entry->player && entry->player->game_data->hp == 0) {
-                    render_nine_slice(
-                        ImGui::GetForegroundDrawList(), entry_background_texture->id(),
-                        entry_background_texture->size() / 2.f, pos, size, {8.5f, 11.f});
-                }
-
-                pos.y += player_list_row_height * scale;
+        for (size_t i = 0; i < view.size(); i++) {
+            if (view.dead[i]) {
+                auto pos = windowpos + ImVec2{0.f, row_tops[i]} - ImVec2{10.f, 8.f} * scale;
+                render_nine_slice(ImGui::GetForegroundDrawList(), entry_background_texture->id(),
+                                  entry_background_texture->size() / 2.f, pos, size,
+                                  {8.5f, 11.f});
             }
         }
     }
 
+    // Draw each player's network details across the whole row under them
+    for (auto &[i, top] : details_tops) {
+        auto &text = view.entries[i]->network_details;
+        auto text_pos =
+            windowpos + ImVec2{0.f, top + (network_details_row_height - font_size) / 2.f * scale};
+        ImGui::GetForegroundDrawList()->AddText(text_pos, ImGui::GetColorU32(pale_gold),
+                                                text.str().data(),
+                                                text.str().data() + text.str().size());
+    }
+
     render_block_player(is_block_player_open, windowpos, player_count);
     render_disconnect(is_disconnect_open, windowpos, windowsize);
 
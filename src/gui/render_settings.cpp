@@ -0,0 +1,81 @@
+#include "render_settings.hpp"
+#include "styles.hpp"
+#include "utils.hpp"
+
+#include "../config.hpp"
+#include "../renderer/texture.hpp"
+
+#include <imgui.h>
+
+#include <memory>
+
+using namespace std;
+
+static shared_ptr<gg::renderer::texture> background_texture;
+
+void gg::gui::initialize_settings() {
+    background_texture = renderer::load_texture_from_resource("MENU_FL_Equip_waku");
+}
+
+void gg::gui::render_settings(bool is_open) {
+    static fade_in_out fade_in_out;
+
+    // The game hides the cursor, so draw one while the panel can be clicked
+    ImGui::GetIO().MouseDrawCursor = is_open;
+
+    if (!fade_in_out.animate(is_open)) {
+        return;
+    }
+
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0);
+    ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, {0, 0});
+    ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2{8, 8} * scale);
+    ImGui::PushStyleVar(ImGuiStyleVar_Alpha, fade_in_out.alpha);
+
+    auto viewport = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(viewport->GetCenter(), ImGuiCond_Always, {.5f, .5f});
+    ImGui::SetNextWindowBgAlpha(0);
+    ImGui::Begin("settings", nullptr,
+                 ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+                     ImGuiWindowFlags_NoSavedSettings);
+
+    ImGui::TextColored(pale_gold, "Settings");
+
+    // Changes apply immediately, since the overlay reads these every frame
+    auto changed = false;
+    changed |= ImGui::Checkbox("Show in-game names", &config::show_in_game_name);
+    changed |= ImGui::Checkbox("Show rune levels", &config::show_level);
+    changed |= ImGui::Checkbox("Show Steam names", &config::show_steam_name);
+    changed |= ImGui::Checkbox("Show Steam avatars", &config::show_steam_avatar);
+    changed |= ImGui::Checkbox("Highlight Steam friends", &config::show_steam_relationship);
+    changed |= ImGui::Checkbox("Show ping", &config::show_ping);
+    changed |= ImGui::Checkbox("Show yourself", &config::show_yourself);
+
+    // Same range as ergg.ini, on a log scale so the usual values around 100ms are easy to pick
+    auto [min_ping, max_ping] = config::get_range(config::high_ping);
+    auto high_ping = static_cast<int>(config::high_ping);
+    ImGui::SetNextItemWidth(200.f * scale);
+    if (ImGui::SliderInt("High ping", &high_ping, static_cast<int>(min_ping),
+                         static_cast<int>(max_ping), "%d ms", ImGuiSliderFlags_Logarithmic)) {
+        config::high_ping = high_ping;
+        changed = true;
+    }
+
+    auto windowpos = ImGui::GetWindowPos();
+    auto windowsize = ImGui::GetWindowSize();
+
+    ImGui::End();
+
+    if (background_texture) {
+        auto padding = ImVec2{32, 28} * scale;
+        render_nine_slice(ImGui::GetBackgroundDrawList(), background_texture->id(),
+                          background_texture->size(), windowpos - padding,
+                          windowsize + padding * 2.f, {56.f, 56.f}, .8f * fade_in_out.alpha);
+    }
+
+    ImGui::PopStyleVar(4);
+
+    if (changed) {
+        config::save();
+    }
+}
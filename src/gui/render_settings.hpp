@@ -0,0 +1,12 @@
+#pragma once
+
+#include <imgui.h>
+
+namespace gg {
+namespace gui {
+
+void initialize_settings();
+void render_settings(bool is_open);
+
+}
+}
@@ -0,0 +1,72 @@
+#include "text_cache.hpp"
+#include "fonts.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * How often text that's being shown requests its glyphs again, so they aren't evicted from the
+ * font atlas
+ */
+static constexpr int glyph_request_interval = 60;
+
+static bool is_non_ascii(string_view text) {
+    return ranges::any_of(text, [](unsigned char c) { return c >= 0x80; });
+}
+
+gg::gui::cached_text::cached_text(string_view text)
+    : text(text),
+      has_non_ascii(is_non_ascii(text)) {}
+
+gg::gui::cached_text &gg::gui::cached_text::operator=(string_view new_text) {
+    if (new_text != text) {
+        text = new_text;
+        has_non_ascii = is_non_ascii(text);
+        glyphs_requested = false;
+        measured_font = nullptr;
+    }
+    return *this;
+}
+
+ImVec2 gg::gui::cached_text::size(float wrap_width) const {
+    if (has_non_ascii) {
+        auto frame = ImGui::GetFrameCount();
+        if (!glyphs_requested || frame - glyphs_requested_frame >= glyph_request_interval) {
+            glyphs_requested = true;
+            glyphs_requested_frame = frame;
+            gg::gui::request_glyphs(text);
+        }
+    }
+
+    auto font = ImGui::GetFont();
+    auto font_size = ImGui::GetFontSize();
+    if (font != measured_font || font_size != measured_font_size ||
+        wrap_width != measured_wrap_width || font_generation != measured_font_generation) {
+        measured_size = ImGui::CalcTextSize(text.data(), text.data() + text.size(), false,
+                                            wrap_width > 0.f ? wrap_width : -1.f);
+        measured_font = font;
+        measured_font_generation = font_generation;
+        measured_font_size = font_size;
+        measured_wrap_width = wrap_width;
+    }
+    return measured_size;
+}
+
+void gg::gui::cached_number::set(int new_value) {
+    if (has_value && new_value == value) {
+        return;
+    }
+
+    value = new_value;
+    has_value = true;
+    text = format(value);
+}
+
+void gg::gui::text(const cached_text &text, const ImVec4 &color) {
+    auto &str = text.str();
+    auto pos = ImGui::GetCursorScreenPos();
+    ImGui::GetWindowDrawList()->AddText(pos, ImGui::GetColorU32(color), str.data(),
+                                        str.data() + str.size());
+    ImGui::Dummy(text.size());
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <string>
+#include <string_view>
+
+namespace gg {
+namespace gui {
+
+/**
+ * A string that remembers its measured size. It's only measured again when the text, font, font
+ * size, or wrap width changes, so static or rarely changing text doesn't need to be measured every
+ * frame. Text with characters outside of the default font range also keeps requesting their glyphs
+ * while it's shown, so they stay in the font atlas.
+ */
+class cached_text {
+private:
+    std::string text;
+    bool has_non_ascii{false};
+
+    mutable bool glyphs_requested{false};
+    mutable int glyphs_requested_frame{0};
+
+    mutable ImVec2 measured_size;
+    mutable unsigned int measured_font_generation{0};
+    mutable const ImFont *measured_font{nullptr};
+    mutable float measured_font_size{0.f};
+    mutable float measured_wrap_width{0.f};
+
+public:
+    cached_text() = default;
+    cached_text(std::string_view text);
+    cached_text(const char *text)
+        : cached_text(std::string_view{text}) {}
+
+    /**
+     * Replace the text, keeping the measurement if it's the same
+     */
+    cached_text &operator=(std::string_view text);
+    cached_text &operator=(const char *text) { return *this = std::string_view{text}; }
+
+    const std::string &str() const { return text; }
+    bool empty() const { return text.empty(); }
+
+    /**
+     * @returns the size of the text in the current font, wrapped to the given width if it's
+     * positive
+     */
+    ImVec2 size(float wrap_width = 0.f) const;
+};
+
+/**
+ * Text showing a number, which is only formatted again when the number changes
+ */
+class cached_number {
+private:
+    std::string (*format)(int);
+    int value;
+    bool has_value{false};
+    cached_text text;
+
+public:
+    explicit cached_number(std::string (*format)(int))
+        : format(format) {}
+
+    void set(int value);
+
+    const cached_text &get() const { return text; }
+    bool empty() const { return !has_value; }
+};
+
+/**
+ * Draw cached text at the cursor position and advance the cursor past it, like ImGui::TextColored
+ * but without formatting or measuring the text again
+ */
+void text(const cached_text &text, const ImVec4 &color);
+
+}
+}
@@ -0,0 +1,141 @@
+#include "input.hpp"
+#include "config.hpp"
+#include "spsc_queue.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <atomic>
+
+using namespace std;
+
+/**
+ * Defined in imgui_impl_win32.cpp. It isn't declared in the header, but isn't static either so
+ * other code can map key messages the same way.
+ */
+extern ImGuiKey ImGui_ImplWin32_KeyEventToImGuiKey(WPARAM wparam, LPARAM lparam);
+
+struct key_event {
+    ImGuiKey key;
+    chrono::steady_clock::time_point time;
+};
+
+static gg::spsc_queue<key_event, 64> key_events;
+
+static atomic<bool> interactive = false;
+
+/**
+ * One bit per named ImGui key, set for every key the overlay uses. It's written by the render task
+ * when the config changes and read by the window procedure.
+ */
+static array<atomic<uint64_t>, (ImGuiKey_NamedKey_COUNT + 63) / 64> watched_keys;
+
+static array<optional<chrono::steady_clock::time_point>, ImGuiKey_NamedKey_COUNT> pressed_keys;
+
+static int key_index(ImGuiKey key) {
+    if (key < ImGuiKey_NamedKey_BEGIN || key >= ImGuiKey_NamedKey_END) {
+        return -1;
+    }
+    return key - ImGuiKey_NamedKey_BEGIN;
+}
+
+static bool is_watched(ImGuiKey key) {
+    auto index = key_index(key);
+    return index != -1 &&
+           (watched_keys[index / 64].load(memory_order_relaxed) & (1ull << (index % 64)));
+}
+
+static void watch_keys() {
+    auto bits = array<uint64_t, watched_keys.size()>{};
+    auto watch = [&](ImGuiKey key) {
+        auto index = key_index(key);
+        if (index != -1) {
+            bits[index / 64] |= 1ull << (index % 64);
+        }
+    };
+
+    watch(gg::config::toggle_logs_key);
+    watch(gg::config::toggle_player_list_key);
+    watch(gg::config::block_player_key);
+    watch(gg::config::block_duration_key);
+    watch(gg::config::disconnect_key);
+    watch(gg::config::toggle_settings_key);
+    watch(gg::config::toggle_network_details_key);
+    watch(gg::config::capture_trace_key);
+    watch(ImGuiKey_Escape);
+    for (int i = 0; i < 9; i++) {
+        watch(static_cast<ImGuiKey>(ImGuiKey_1 + i));
+        watch(static_cast<ImGuiKey>(ImGuiKey_Keypad1 + i));
+    }
+    if (gg::config::debug) {
+        watch(ImGuiKey_Keypad0);
+        watch(ImGuiKey_H);
+        watch(gg::config::toggle_memory_key);
+    }
+
+    for (size_t i = 0; i < bits.size(); i++) {
+        watched_keys[i].store(bits[i], memory_order_relaxed);
+    }
+}
+
+bool gg::input::handle_message(unsigned int msg, WPARAM wparam, LPARAM lparam) {
+    switch (msg) {
+    case WM_KEYDOWN:
+    case WM_SYSKEYDOWN: {
+        auto key = ImGui_ImplWin32_KeyEventToImGuiKey(wparam, lparam);
+        if (!is_watched(key)) {
+            return interactive.load(memory_order_relaxed);
+        }
+
+        // Bit 30 is set for auto-repeated key downs, which aren't new presses
+        if (!(lparam & (1 << 30))) {
+            key_events.push({key, chrono::steady_clock::now()});
+        }
+        return true;
+    }
+
+    // Releases and focus changes are always passed on, so ImGui never thinks a key is stuck down
+    case WM_KEYUP:
+    case WM_SYSKEYUP:
+    case WM_SETFOCUS:
+    case WM_KILLFOCUS:
+        return true;
+
+    default:
+        return interactive.load(memory_order_relaxed);
+    }
+}
+
+void gg::input::set_interactive(bool value) { interactive.store(value, memory_order_relaxed); }
+
+void gg::input::update() {
+    static auto watched_revision = optional<unsigned int>{};
+    if (watched_revision != gg::config::revision) {
+        watch_keys();
+        watched_revision = gg::config::revision;
+    }
+
+    pressed_keys.fill(nullopt);
+    while (auto event = key_events.pop()) {
+        auto &pressed = pressed_keys[key_index(event->key)];
+        if (!pressed) {
+            pressed = event->time;
+        }
+    }
+}
+
+optional<chrono::steady_clock::time_point> gg::input::pressed(ImGuiKey key) {
+    auto index = key_index(key);
+    return index != -1 ? pressed_keys[index] : nullopt;
+}
+
+void gg::input::log_latency(ImGuiKey key, string_view action) {
+    auto time = pressed(key);
+    if (!time) {
+        return;
+    }
+
+    auto latency = chrono::steady_clock::now() - *time;
+    SPDLOG_DEBUG("{} {}us after key press", action,
+                 chrono::duration_cast<chrono::microseconds>(latency).count());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <imgui.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+namespace gg {
+namespace input {
+
+/**
+ * Called by the window procedure for every message. Presses of the keys the overlay uses are
+ * timestamped and queued for the render task.
+ *
+ * @returns true if the message should be passed on to ImGui. While the overlay isn't interactive,
+ * only messages for the keys it uses are.
+ */
+bool handle_message(unsigned int msg, WPARAM wparam, LPARAM lparam);
+
+/**
+ * Set whether the overlay currently has a window that takes mouse and keyboard input, such as
+ * the settings panel. Called by the render task each frame.
+ */
+void set_interactive(bool interactive);
+
+/**
+ * Take the key presses queued since the last call, and update which keys are watched if the
+ * config changed. Called by the render task before each frame.
+ */
+void update();
+
+/**
+ * @returns when the key was pressed, if it was pressed since the last update()
+ */
+std::optional<std::chrono::steady_clock::time_point> pressed(ImGuiKey key);
+
+/**
+ * Log how long it's been since the key was pressed, to measure how long an action takes to respond
+ * to a hotkey. Nothing is logged if the key wasn't pressed this frame.
+ */
+void log_latency(ImGuiKey key, std::string_view action);
+
+}
+}
@@ -0,0 +1,171 @@
+#include "keycodes.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+// clang-format off
+static constexpr auto keycodes_by_name = array<pair<string_view, ImGuiKey>, 120>{{
+    {"tab", ImGuiKey_Tab}, {"leftarrow", ImGuiKey_LeftArrow}, {"rightarrow", ImGuiKey_RightArrow},
+    {"uparrow", ImGuiKey_UpArrow}, {"downarrow", ImGuiKey_DownArrow}, {"pageup", ImGuiKey_PageUp},
+    {"pagedown", ImGuiKey_PageDown}, {"home", ImGuiKey_Home}, {"end", ImGuiKey_End},
+    {"insert", ImGuiKey_Insert}, {"delete", ImGuiKey_Delete}, {"backspace", ImGuiKey_Backspace},
+    {"space", ImGuiKey_Space}, {"enter", ImGuiKey_Enter}, {"escape", ImGuiKey_Escape},
+    {"leftctrl", ImGuiKey_LeftCtrl}, {"leftshift", ImGuiKey_LeftShift},
+    {"leftalt", ImGuiKey_LeftAlt}, {"leftsuper", ImGuiKey_LeftSuper},
+    {"rightctrl", ImGuiKey_RightCtrl}, {"rightshift", ImGuiKey_RightShift},
+    {"rightalt", ImGuiKey_RightAlt}, {"rightsuper", ImGuiKey_RightSuper},
+    {"menu", ImGuiKey_Menu}, {"0", ImGuiKey_0}, {"1", ImGuiKey_1}, {"2", ImGuiKey_2},
+    {"3", ImGuiKey_3}, {"4", ImGuiKey_4}, {"5", ImGuiKey_5}, {"6", ImGuiKey_6}, {"7", ImGuiKey_7},
+    {"8", ImGuiKey_8}, {"9", ImGuiKey_9}, {"a", ImGuiKey_A}, {"b", ImGuiKey_B}, {"c", ImGuiKey_C},
+    {"d", ImGuiKey_D}, {"e", ImGuiKey_E}, {"f", ImGuiKey_F}, {"g", ImGuiKey_G}, {"h", ImGuiKey_H},
+    {"i", ImGuiKey_I}, {"j", ImGuiKey_J}, {"k", ImGuiKey_K}, {"l", ImGuiKey_L}, {"m", ImGuiKey_M},
+    {"n", ImGuiKey_N}, {"o", ImGuiKey_O}, {"p", ImGuiKey_P}, {"q", ImGuiKey_Q}, {"r", ImGuiKey_R},
+    {"s", ImGuiKey_S}, {"t", ImGuiKey_T}, {"u", ImGuiKey_U}, {"v", ImGuiKey_V}, {"w", ImGuiKey_W},
+    {"x", ImGuiKey_X}, {"y", ImGuiKey_Y}, {"z", ImGuiKey_Z}, {"f1", ImGuiKey_F1},
+    {"f2", ImGuiKey_F2}, {"f3", ImGuiKey_F3}, {"f4", ImGuiKey_F4}, {"f5", ImGuiKey_F5},
+    {"f6", ImGuiKey_F6}, {"f7", ImGuiKey_F7}, {"f8", ImGuiKey_F8}, {"f9", ImGuiKey_F9},
+    {"f10", ImGuiKey_F10}, {"f11", ImGuiKey_F11}, {"f12", ImGuiKey_F12}, {"f13", ImGuiKey_F13},
+    {"f14", ImGuiKey_F14}, {"f15", ImGuiKey_F15}, {"f16", ImGuiKey_F16}, {"f17", ImGuiKey_F17},
+    {"f18", ImGuiKey_F18}, {"f19", ImGuiKey_F19}, {"f20", ImGuiKey_F20}, {"f21", ImGuiKey_F21},
+    {"f22", ImGuiKey_F22}, {"f23", ImGuiKey_F23}, {"f24", ImGuiKey_F24},
+    {"apostrophe", ImGuiKey_Apostrophe}, {"comma", ImGuiKey_Comma}, {"minus", ImGuiKey_Minus},
+    {"period", ImGuiKey_Period}, {"slash", ImGuiKey_Slash}, {"semicolon", ImGuiKey_Semicolon},
+    {"equal", ImGuiKey_Equal}, {"leftbracket", ImGuiKey_LeftBracket},
+    {"backslash", ImGuiKey_Backslash}, {"rightbracket", ImGuiKey_RightBracket},
+    {"graveaccent", ImGuiKey_GraveAccent}, {"capslock", ImGuiKey_CapsLock},
+    {"scrolllock", ImGuiKey_ScrollLock}, {"numlock", ImGuiKey_NumLock},
+    {"printscreen", ImGuiKey_PrintScreen}, {"pause", ImGuiKey_Pause}, {"keypad0", ImGuiKey_Keypad0},
+    {"keypad1", ImGuiKey_Keypad1}, {"keypad2", ImGuiKey_Keypad2}, {"keypad3", ImGuiKey_Keypad3},
+    {"keypad4", ImGuiKey_Keypad4}, {"keypad5", ImGuiKey_Keypad5}, {"keypad6", ImGuiKey_Keypad6},
+    {"keypad7", ImGuiKey_Keypad7}, {"keypad8", ImGuiKey_Keypad8}, {"keypad9", ImGuiKey_Keypad9},
+    {"keypaddecimal", ImGuiKey_KeypadDecimal}, {"keypaddivide", ImGuiKey_KeypadDivide},
+    {"keypadmultiply", ImGuiKey_KeypadMultiply}, {"keypadsubtract", ImGuiKey_KeypadSubtract},
+    {"keypadadd", ImGuiKey_KeypadAdd}, {"keypadenter", ImGuiKey_KeypadEnter},
+    {"keypadequal", ImGuiKey_KeypadEqual}, {"appback", ImGuiKey_AppBack},
+    {"appforward", ImGuiKey_AppForward}, {"gamepadstart", ImGuiKey_GamepadStart},
+}};
+// clang-format on
+
+/**
+ * Key names are looked up in a minimal-collision table built at compile time with the "hash and
+ * displace" method. Names are first grouped into buckets, and then each bucket is given a seed
+ * that places all of its names in free slots of the table. A lookup is one hash of the name, one
+ * seed, and one string comparison.
+ */
+static constexpr unsigned int table_bits = 9;
+static constexpr size_t table_size = 1 << table_bits;
+static constexpr size_t bucket_count = 64;
+static constexpr size_t max_bucket_size = 16;
+static constexpr uint16_t empty_slot = 0xffff;
+
+static constexpr uint64_t hash_name(string_view name) {
+    // FNV-1a
+    auto hash = 0xcbf29ce484222325ull;
+    for (auto c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static constexpr size_t slot_for(uint64_t hash, uint16_t seed) {
+    return ((hash ^ seed) * 0x9e3779b97f4a7c15ull) >> (64 - table_bits);
+}
+
+struct perfect_hash_table {
+    array<uint16_t, bucket_count> seeds;
+    array<uint16_t, table_size> slots;
+};
+
+static consteval perfect_hash_table build_table() {
+    auto table = perfect_hash_table{};
+    table.slots.fill(empty_slot);
+
+    auto hashes = array<uint64_t, keycodes_by_name.size()>{};
+    auto members = array<array<uint16_t, max_bucket_size>, bucket_count>{};
+    auto member_counts = array<size_t, bucket_count>{};
+    for (size_t i = 0; i < keycodes_by_name.size(); i++) {
+        hashes[i] = hash_name(keycodes_by_name[i].first);
+        auto bucket = hashes[i] % bucket_count;
+        if (member_counts[bucket] == max_bucket_size) {
+            throw "Too many key names in one bucket";
+        }
+        members[bucket][member_counts[bucket]++] = static_cast<uint16_t>(i);
+    }
+
+    // Place the largest buckets first, while the table is mostly empty
+    auto order = array<size_t, bucket_count>{};
+    for (size_t i = 0; i < bucket_count; i++) {
+        order[i] = i;
+    }
+    for (size_t i = 0; i < bucket_count; i++) {
+        for (size_t j = i + 1; j < bucket_count; j++) {
+            if (member_counts[order[j]] > member_counts[order[i]]) {
+                swap(order[i], order[j]);
+            }
+        }
+    }
+
+    for (auto bucket : order) {
+        auto count = member_counts[bucket];
+        if (count == 0) {
+            break;
+        }
+
+        for (uint32_t seed = 0;; seed++) {
+            if (seed == empty_slot) {
+                throw "No seed places every key name in the bucket";
+            }
+
+            auto candidate_slots = array<size_t, max_bucket_size>{};
+            auto placed = true;
+            for (size_t i = 0; placed && i < count; i++) {
+                auto slot = slot_for(hashes[members[bucket][i]], static_cast<uint16_t>(seed));
+                placed = table.slots[slot] == empty_slot;
+                for (size_t j = 0; placed && j < i; j++) {
+                    placed = candidate_slots[j] != slot;
+                }
+                candidate_slots[i] = slot;
+            }
+
+            if (placed) {
+                table.seeds[bucket] = static_cast<uint16_t>(seed);
+                for (size_t i = 0; i < count; i++) {
+                    table.slots[candidate_slots[i]] = members[bucket][i];
+                }
+                break;
+            }
+        }
+    }
+
+    return table;
+}
+
+static constexpr auto table = build_table();
+
+static constexpr optional<ImGuiKey> lookup(string_view name) {
+    auto hash = hash_name(name);
+    auto index = table.slots[slot_for(hash, table.seeds[hash % bucket_count])];
+    if (index == empty_slot || keycodes_by_name[index].first != name) {
+        return nullopt;
+    }
+    return keycodes_by_name[index].second;
+}
+
+static_assert(ranges::all_of(keycodes_by_name,
+                             [](auto &entry) { return lookup(entry.first) == entry.second; }));
+static_assert(!lookup("f25").has_value());
+
+optional<ImGuiKey> gg::keycodes::find(string_view name) { return lookup(name); }
+
+string_view gg::keycodes::name(ImGuiKey key) {
+    for (auto &[name, value] : keycodes_by_name) {
+        if (value == key) {
+            return name;
+        }
+    }
+    return {};
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <imgui.h>
+
+#include <optional>
+#include <string_view>
+
+namespace gg {
+namespace keycodes {
+
+/**
+ * @returns the key with the given lowercase name, as written in ergg.ini
+ */
+std::optional<ImGuiKey> find(std::string_view name);
+
+/**
+ * @returns the lowercase name of the given key, or an empty string if it doesn't have one
+ */
+std::string_view name(ImGuiKey key);
+
+}
+}
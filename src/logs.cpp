@@ -2,33 +2,55 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 
 using namespace std;
 
+/**
+ * Messages are logged from background threads while the render thread draws them, so every access
+ * to the ring buffer holds this lock
+ */
+static mutex logs_mutex;
+
 static auto logs_ring_ptr = make_unique<array<string, 50>>();
 static size_t logs_begin = 0;
 static size_t logs_size = 0;
 
-size_t gg::logs::size() { return logs_size; }
+size_t gg::logs::size() {
+    auto lock = lock_guard{logs_mutex};
+    return logs_size;
+}
 
-string &gg::logs::append() {
+void gg::logs::log(string_view message) {
+    auto lock = lock_guard{logs_mutex};
     auto &logs_ring = *logs_ring_ptr;
 
+    // Reuse the oldest message's storage when the buffer is full
     if (logs_size == logs_ring.size()) {
-        auto &oldest_entry = logs_ring[logs_begin];
+        logs_ring[logs_begin].assign(message);
         logs_begin = (logs_begin + 1) % logs_ring.size();
-        return oldest_entry;
+    } else {
+        logs_ring[(logs_begin + logs_size++) % logs_ring.size()].assign(message);
     }
-    return logs_ring[logs_size++];
 }
 
-void gg::logs::log(string &&message) { append() = move(message); }
-
 void gg::logs::for_each(function<void(const string &)> callback) {
+    auto lock = lock_guard{logs_mutex};
     auto &logs_ring = *logs_ring_ptr;
 
     auto limit = logs_begin + logs_size;
     for (size_t i = logs_begin; i < limit; i++) {
         callback(logs_ring[i % logs_ring.size()]);
     }
-}
\ No newline at end of file
+}
+
+gg::memory::usage gg::logs::memory_usage() {
+    auto lock = lock_guard{logs_mutex};
+    auto result = memory::usage{.count = logs_size, .bytes = sizeof(*logs_ring_ptr)};
+    for (auto &message : *logs_ring_ptr) {
+        if (message.capacity() > string{}.capacity()) {
+            result.bytes += message.capacity() + 1;
+        }
+    }
+    return result;
+}
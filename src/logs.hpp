@@ -1,7 +1,10 @@
 #pragma once
 
+#include "memory.hpp"
+
 #include <functional>
 #include <string>
+#include <string_view>
 
 namespace gg {
 namespace logs {
@@ -10,13 +13,20 @@ size_t size();
 
 /**
  * Append a new log message to the ring buffer, overwriting the oldest message if the buffer is
- * full
+ * full. Safe to call from any thread.
  */
-std::string &append();
-
-void log(std::string &&message);
+void log(std::string_view message);
 
+/**
+ * Call a function with each message, oldest first. The buffer is locked during the calls, so the
+ * callback must not log anything.
+ */
 void for_each(std::function<void(const std::string &)> callback);
 
+/**
+ * @returns how many messages are in the ring buffer, and the memory used to store them
+ */
+memory::usage memory_usage();
+
 }
 }
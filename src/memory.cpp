@@ -0,0 +1,182 @@
+#include "memory.hpp"
+#include "config.hpp"
+#include "encounters.hpp"
+#include "fake_block.hpp"
+#include "logs.hpp"
+#include "player_list.hpp"
+#include "relationship_cache.hpp"
+#include "telemetry.hpp"
+#include "gui/fonts.hpp"
+#include "renderer/renderer.hpp"
+#include "renderer/texture.hpp"
+
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <string>
+
+using namespace std;
+
+static constexpr auto check_interval = chrono::seconds{1};
+
+/**
+ * Each ImGui allocation is prefixed with its size, so it can be subtracted from the total when
+ * it's freed. The prefix is 16 bytes so the allocation is still aligned like malloc's.
+ */
+static constexpr size_t allocation_header_size = 16;
+
+static atomic<size_t> imgui_allocations{0};
+static atomic<size_t> imgui_bytes{0};
+
+static void *imgui_alloc(size_t size, void *) {
+    auto block = static_cast<char *>(malloc(size + allocation_header_size));
+    if (!block) {
+        return nullptr;
+    }
+
+    *reinterpret_cast<size_t *>(block) = size;
+    imgui_allocations.fetch_add(1, memory_order_relaxed);
+    imgui_bytes.fetch_add(size, memory_order_relaxed);
+    return block + allocation_header_size;
+}
+
+static void imgui_free(void *ptr, void *) {
+    if (!ptr) {
+        return;
+    }
+
+    auto block = static_cast<char *>(ptr) - allocation_header_size;
+    imgui_allocations.fetch_sub(1, memory_order_relaxed);
+    imgui_bytes.fetch_sub(*reinterpret_cast<size_t *>(block), memory_order_relaxed);
+    free(block);
+}
+
+/**
+ * @returns the heap memory used by a string, which is none if it fits in the string itself
+ */
+static size_t string_bytes(const string &s) {
+    return s.capacity() > string{}.capacity() ? s.capacity() + 1 : 0;
+}
+
+static gg::memory::usage player_list_usage() {
+    auto &entries = gg::player_list_entries;
+    auto &view = gg::player_list;
+
+    auto result = gg::memory::usage{
+        .bytes = entries.capacity() * sizeof(entries[0]) +
+                 view.entries.capacity() * sizeof(view.entries[0]) +
+                 view.slots.capacity() * sizeof(view.slots[0]) +
+                 view.steam_ids.capacity() * sizeof(view.steam_ids[0]) +
+                 view.avatars.capacity() * sizeof(view.avatars[0]) + view.dead.capacity() / 8,
+    };
+
+    for (auto &entry : entries) {
+        if (!entry) {
+            continue;
+        }
+
+        result.count++;
+        const gg::gui::cached_text *texts[] = {
+            &entry->in_game_name,      &entry->steam_name,
+            &entry->network_details,   &entry->encounter_badge,
+            &entry->level_text.get(),  &entry->ping_text.get(),
+            &entry->jitter_text.get(), &entry->session_time_text.get(),
+        };
+        for (auto text : texts) {
+            result.bytes += string_bytes(text->str());
+        }
+    }
+    return result;
+}
+
+static gg::memory::usage avatar_usage() {
+    auto result = gg::memory::usage{};
+    for (auto &entry : gg::player_list_entries) {
+        if (entry && entry->steam_avatar) {
+            result.count++;
+            result.bytes += entry->steam_avatar->memory_size();
+        }
+    }
+    return result;
+}
+
+string gg::memory::format_bytes(size_t bytes) {
+    if (bytes >= 1024 * 1024) {
+        return format("{:.1f} MB", bytes / (1024. * 1024.));
+    }
+    return format("{:.1f} KB", bytes / 1024.);
+}
+
+void gg::memory::track_imgui_allocations() {
+    ImGui::SetAllocatorFunctions(imgui_alloc, imgui_free, nullptr);
+}
+
+gg::memory::report gg::memory::measure() {
+    auto descriptors = gg::renderer::get_descriptor_usage();
+    return {
+        .textures = gg::renderer::texture_memory(),
+        .font_atlas = gg::gui::font_memory(),
+        .avatars = avatar_usage(),
+        .descriptors_used = descriptors.used,
+        .descriptors_capacity = descriptors.capacity,
+        .imgui_heap = {.count = imgui_allocations.load(memory_order_relaxed),
+                       .bytes = imgui_bytes.load(memory_order_relaxed)},
+        .logs = gg::logs::memory_usage(),
+        .player_list = player_list_usage(),
+        .telemetry = gg::telemetry::memory_usage(),
+        .blocklist = gg::blocklist_memory_usage(),
+        .encounters = gg::encounters::memory_usage(),
+        .relationship_cache = gg::relationship_cache::memory_usage(),
+    };
+}
+
+void gg::memory::log(const report &r) {
+    SPDLOG_INFO("VRAM: {} in {} textures (font atlas {}, {} avatars {}), {}/{} descriptors",
+                format_bytes(r.vram_bytes()), r.textures.count, format_bytes(r.font_atlas.bytes),
+                r.avatars.count, format_bytes(r.avatars.bytes), r.descriptors_used,
+                r.descriptors_capacity);
+    SPDLOG_INFO("RAM: {} (ImGui {} in {} allocations, logs {}, player list {}, telemetry {}, "
+                "blocklist {} for {} players, encounter history {} for {} players, "
+                "relationship cache {})",
+                format_bytes(r.ram_bytes()), format_bytes(r.imgui_heap.bytes), r.imgui_heap.count,
+                format_bytes(r.logs.bytes), format_bytes(r.player_list.bytes),
+                format_bytes(r.telemetry.bytes), format_bytes(r.blocklist.bytes), r.blocklist.count,
+                format_bytes(r.encounters.bytes), r.encounters.count,
+                format_bytes(r.relationship_cache.bytes));
+}
+
+void gg::memory::update() {
+    static auto last_check_time = chrono::steady_clock::time_point{};
+    static auto over_budget = false;
+
+    auto now = chrono::steady_clock::now();
+    if (now - last_check_time < check_interval) {
+        return;
+    }
+    last_check_time = now;
+
+    auto r = measure();
+    auto vram_over = r.vram_bytes() > size_t{gg::config::vram_budget_mb} * 1024 * 1024;
+    auto ram_over = r.ram_bytes() > size_t{gg::config::ram_budget_mb} * 1024 * 1024;
+
+    // Only warn when the budget is first exceeded, but keep evicting while it's over, since the
+    // caches fill up again as new players and names show up
+    if ((vram_over || ram_over) && !over_budget) {
+        SPDLOG_WARN("Over the memory budget ({} VRAM, {} RAM), evicting caches",
+                    format_bytes(r.vram_bytes()), format_bytes(r.ram_bytes()));
+        log(r);
+    }
+    over_budget = vram_over || ram_over;
+
+    // Glyphs use VRAM in the atlas texture and RAM in ImGui's copy of the font data
+    if (over_budget) {
+        gg::gui::trim_fonts();
+    }
+    if (ram_over) {
+        gg::telemetry::trim();
+    }
+}
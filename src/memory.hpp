@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace gg {
+namespace memory {
+
+struct usage {
+    size_t count{0};
+    size_t bytes{0};
+};
+
+/**
+ * Memory used by the mod, by what it's used for. The font atlas and avatars are part of the
+ * texture total, not in addition to it.
+ */
+struct report {
+    usage textures;
+    usage font_atlas;
+    usage avatars;
+    unsigned int descriptors_used{0};
+    unsigned int descriptors_capacity{0};
+
+    usage imgui_heap;
+    usage logs;
+    usage player_list;
+    usage telemetry;
+    usage blocklist;
+    usage encounters;
+    usage relationship_cache;
+
+    size_t vram_bytes() const { return textures.bytes; }
+    size_t ram_bytes() const {
+        return imgui_heap.bytes + logs.bytes + player_list.bytes + telemetry.bytes +
+               blocklist.bytes + encounters.bytes + relationship_cache.bytes;
+    }
+};
+
+/**
+ * Route ImGui's allocations through a counter, so the overlay's share of the heap can be reported.
+ * Must be called before the ImGui context is created.
+ */
+void track_imgui_allocations();
+
+report measure();
+
+/**
+ * @returns a size in KB or MB, whichever is more readable
+ */
+std::string format_bytes(size_t bytes);
+
+/**
+ * Write a report to the log
+ */
+void log(const report &r);
+
+/**
+ * Once a second, compare the mod's memory use against the budgets in ergg.ini, and evict caches
+ * that can be rebuilt if either one is exceeded. Called by the render task each frame.
+ */
+void update();
+
+}
+}
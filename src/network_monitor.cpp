@@ -0,0 +1,101 @@
+#include "network_monitor.hpp"
+
+#include "steam.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+static constexpr auto sample_interval = chrono::milliseconds{250};
+
+/**
+ * Outgoing data waiting longer than this before it's sent counts as congestion
+ */
+static constexpr int64_t congested_queue_time_us = 50'000;
+
+static mutex network_monitor_mutex;
+static vector<uint64_t> peers;
+static unordered_map<uint64_t, gg::network_monitor::peer_status> statuses;
+
+static gg::network_monitor::peer_status sample_peer(uint64_t steam_id) {
+    auto status = gg::steam::get_connection_status(steam_id);
+
+    return {
+        .ping = status.m_nPing,
+        .quality_local = status.m_flConnectionQualityLocal,
+        .quality_remote = status.m_flConnectionQualityRemote,
+        .out_bytes_per_sec = status.m_flOutBytesPerSec,
+        .in_bytes_per_sec = status.m_flInBytesPerSec,
+        .send_rate_bytes_per_sec = status.m_nSendRateBytesPerSecond,
+        .pending_bytes = status.m_cbPendingUnreliable + status.m_cbPendingReliable +
+                         status.m_cbSentUnackedReliable,
+        .queue_time_us = status.m_usecQueueTime,
+    };
+}
+
+static void sample_peers() {
+    GG_TRACE_THREAD("network monitor");
+
+    auto current_peers = vector<uint64_t>{};
+    auto samples = vector<pair<uint64_t, gg::network_monitor::peer_status>>{};
+
+    while (true) {
+        this_thread::sleep_for(sample_interval);
+        GG_TRACE_ZONE("sample_peers");
+
+        {
+            auto lock = lock_guard{network_monitor_mutex};
+            current_peers = peers;
+        }
+
+        // Steam's networking interfaces are thread safe, so this is done without holding the lock
+        samples.clear();
+        for (auto steam_id : current_peers) {
+            samples.emplace_back(steam_id, sample_peer(steam_id));
+        }
+
+        // Skip any players that left while this was sampling
+        auto lock = lock_guard{network_monitor_mutex};
+        for (auto &[steam_id, status] : samples) {
+            if (ranges::find(peers, steam_id) != peers.end()) {
+                statuses[steam_id] = status;
+            }
+        }
+    }
+}
+
+float gg::network_monitor::peer_status::uplink_utilization() const {
+    if (send_rate_bytes_per_sec <= 0) {
+        return 0.f;
+    }
+    return out_bytes_per_sec / send_rate_bytes_per_sec;
+}
+
+bool gg::network_monitor::peer_status::congested() const {
+    return queue_time_us > congested_queue_time_us ||
+           (send_rate_bytes_per_sec > 0 && pending_bytes > send_rate_bytes_per_sec / 4);
+}
+
+void gg::network_monitor::start() { thread(sample_peers).detach(); }
+
+void gg::network_monitor::set_peers(vector<uint64_t> steam_ids) {
+    erase(steam_ids, 0);
+
+    auto lock = lock_guard{network_monitor_mutex};
+    peers = move(steam_ids);
+    erase_if(statuses, [](auto &entry) { return ranges::find(peers, entry.first) == peers.end(); });
+}
+
+optional<gg::network_monitor::peer_status> gg::network_monitor::get(uint64_t steam_id) {
+    auto lock = lock_guard{network_monitor_mutex};
+    auto it = statuses.find(steam_id);
+    if (it == statuses.end()) {
+        return nullopt;
+    }
+    return it->second;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gg {
+namespace network_monitor {
+
+/**
+ * Connection status for one player, from SteamNetConnectionRealTimeStatus_t
+ */
+struct peer_status {
+    int ping{-1};
+
+    /**
+     * Fraction of packets delivered in each direction, or negative if unknown
+     */
+    float quality_local{-1.f};
+    float quality_remote{-1.f};
+
+    float out_bytes_per_sec{0.f};
+    float in_bytes_per_sec{0.f};
+
+    /**
+     * Steam's estimate of how fast we can send to this player
+     */
+    int send_rate_bytes_per_sec{0};
+
+    /**
+     * Bytes waiting to be sent or acknowledged, and how long new data waits before it's sent
+     */
+    int pending_bytes{0};
+    int64_t queue_time_us{0};
+
+    /**
+     * @returns the fraction of the estimated send rate used by outgoing traffic
+     */
+    float uplink_utilization() const;
+
+    /**
+     * @returns true if outgoing data is piling up, which means our own uplink can't keep up. A
+     * high ping without this means the delay is on the other player's end or in between.
+     */
+    bool congested() const;
+};
+
+/**
+ * Start the background thread that samples the connection to each player a few times per second
+ */
+void start();
+
+/**
+ * Set the players to sample. Called by the render thread when the players in the session change.
+ */
+void set_peers(std::vector<uint64_t> steam_ids);
+
+/**
+ * @returns the latest status for a player, if they've been sampled
+ */
+std::optional<peer_status> get(uint64_t steam_id);
+
+}
+}
@@ -0,0 +1,33 @@
+#include "ping_smoother.hpp"
+
+#include <cstdlib>
+
+using namespace std;
+
+static constexpr auto jitter_sample_interval = chrono::seconds{1};
+
+void gg::ping_smoother::update(int ping) {
+    cumulative_error += ping - value;
+
+    // Only update ping if it's consistently far off, to avoid UI flickering
+    if (value <= 0 || abs(cumulative_error) > 100) {
+        value = ping;
+        cumulative_error = 0;
+    }
+}
+
+bool gg::ping_smoother::sample(int ping, chrono::steady_clock::time_point now) {
+    if (now - last_sample_time < jitter_sample_interval) {
+        return false;
+    }
+
+    // Estimate jitter from the change in ping between samples taken once a second, with the same
+    // smoothing as RTP interarrival jitter (RFC 3550)
+    if (last_sample > 0 && ping > 0) {
+        auto delta = static_cast<float>(abs(ping - last_sample));
+        jitter += (delta - jitter) / 16.f;
+    }
+    last_sample = ping;
+    last_sample_time = now;
+    return true;
+}
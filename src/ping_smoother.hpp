@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+
+namespace gg {
+
+/**
+ * Smooths the ping reported for a player, so the number shown doesn't flicker, and estimates how
+ * much it varies
+ */
+struct ping_smoother {
+    /**
+     * Ping to show in milliseconds, or -1 if it's unknown
+     */
+    int value{-1};
+
+    /**
+     * Smoothed variation in ping between samples, in milliseconds
+     */
+    float jitter{0.f};
+
+    /**
+     * The last ping sampled for jitter, or -1 if there isn't one yet
+     */
+    int last_sample{-1};
+
+    std::chrono::steady_clock::time_point last_sample_time;
+
+    int cumulative_error{0};
+
+    /**
+     * Update the shown ping with the latest measurement. This only changes when the measurement
+     * has been consistently far off from it.
+     */
+    void update(int ping);
+
+    /**
+     * Take a jitter sample if enough time has passed since the last one
+     *
+     * @returns true if a sample was taken
+     */
+    bool sample(int ping, std::chrono::steady_clock::time_point now);
+};
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace gg {
+namespace platform {
+
+/**
+ * A read-only memory-mapped file. The mapping is released when this goes out of scope.
+ *
+ * This is implemented separately for each platform in mapped_file_win32.cpp and
+ * mapped_file_posix.cpp.
+ */
+class mapped_file {
+private:
+    const char *view{nullptr};
+    size_t view_size{0};
+    bool opened{false};
+
+    void close();
+
+public:
+    explicit mapped_file(const std::filesystem::path &path);
+    mapped_file(mapped_file &&other) noexcept;
+    mapped_file(const mapped_file &) = delete;
+    ~mapped_file();
+
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    bool is_open() const { return opened; }
+    std::span<const char> data() const { return {view, view_size}; }
+};
+
+}
+}
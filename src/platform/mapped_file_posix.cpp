@@ -0,0 +1,58 @@
+#include "mapped_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <utility>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+gg::platform::mapped_file::mapped_file(const fs::path &path) {
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        return;
+    }
+
+    // Empty files can't be mapped, but are still valid
+    if (status.st_size == 0) {
+        ::close(file);
+        opened = true;
+        return;
+    }
+
+    // The mapping keeps the file open, so the descriptor can be closed right away
+    auto size = static_cast<size_t>(status.st_size);
+    auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    view = static_cast<const char *>(mapping);
+    view_size = size;
+    opened = true;
+}
+
+gg::platform::mapped_file::mapped_file(mapped_file &&other) noexcept
+    : view(exchange(other.view, nullptr)),
+      view_size(exchange(other.view_size, 0)),
+      opened(exchange(other.opened, false)) {}
+
+gg::platform::mapped_file::~mapped_file() { close(); }
+
+void gg::platform::mapped_file::close() {
+    if (view) munmap(const_cast<char *>(view), view_size);
+    view = nullptr;
+    view_size = 0;
+    opened = false;
+}
@@ -0,0 +1,59 @@
+#include "mapped_file.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <utility>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+gg::platform::mapped_file::mapped_file(const fs::path &path) {
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return;
+    }
+
+    // Empty files can't be mapped, but are still valid
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        opened = true;
+        return;
+    }
+
+    // The view keeps the mapping and the file open, so the handles can be closed right away
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return;
+    }
+
+    view = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!view) {
+        return;
+    }
+    view_size = static_cast<size_t>(size.QuadPart);
+    opened = true;
+}
+
+gg::platform::mapped_file::mapped_file(mapped_file &&other) noexcept
+    : view(exchange(other.view, nullptr)),
+      view_size(exchange(other.view_size, 0)),
+      opened(exchange(other.opened, false)) {}
+
+gg::platform::mapped_file::~mapped_file() { close(); }
+
+void gg::platform::mapped_file::close() {
+    if (view) UnmapViewOfFile(view);
+    view = nullptr;
+    view_size = 0;
+    opened = false;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace gg {
+namespace platform {
+
+/**
+ * @returns the folder containing the given module, which is where ergg.ini and the logs are kept
+ *
+ * This is implemented separately for each platform in module_win32.cpp and module_posix.cpp. Only
+ * the mod's DLL has a module, so elsewhere this is the working directory.
+ */
+std::filesystem::path get_module_folder(void *module);
+
+/**
+ * @returns a resource embedded in the given module by resources.rc, or nullopt if it isn't found
+ */
+std::optional<std::span<unsigned char>> get_module_resource(void *module,
+                                                            const std::string &name,
+                                                            const std::string &type);
+
+}
+}
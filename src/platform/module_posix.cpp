@@ -0,0 +1,14 @@
+#include "module.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+fs::path gg::platform::get_module_folder(void *) {
+    auto ec = error_code{};
+    return fs::current_path(ec);
+}
+
+optional<span<unsigned char>> gg::platform::get_module_resource(void *, const string &,
+                                                                const string &) {
+    return nullopt;
+}
@@ -0,0 +1,44 @@
+#include "module.hpp"
+
+#include <spdlog/spdlog.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+fs::path gg::platform::get_module_folder(void *module) {
+    wchar_t dll_filename[MAX_PATH] = {0};
+    GetModuleFileNameW(static_cast<HMODULE>(module), dll_filename, MAX_PATH);
+    return fs::path{dll_filename}.parent_path();
+}
+
+optional<span<unsigned char>> gg::platform::get_module_resource(void *module,
+                                                                const string &name,
+                                                                const string &type) {
+    auto handle = static_cast<HMODULE>(module);
+    auto res = FindResourceA(handle, name.data(), type.data());
+    if (!res) {
+        SPDLOG_CRITICAL("Failed to find mod resource ({}) {} {}", GetLastError(), name, type);
+        return {};
+    }
+    auto size = SizeofResource(handle, res);
+    if (!size) {
+        SPDLOG_CRITICAL("Failed to get size of mod resource ({}) {} {}", GetLastError(), name,
+                        type);
+        return {};
+    }
+    auto resource = LoadResource(handle, res);
+    if (!resource) {
+        SPDLOG_CRITICAL("Failed to load mod resource ({}) {} {}", GetLastError(), name, type);
+        return {};
+    }
+    auto data = reinterpret_cast<unsigned char *>(LockResource(resource));
+    if (!data) {
+        SPDLOG_CRITICAL("Failed to get mod resource data ({}) {} {}", GetLastError(), name, type);
+        return {};
+    }
+
+    return span{data, size};
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <span>
+
+namespace gg {
+namespace platform {
+
+/**
+ * Watch a folder for files being created, renamed or written, and call `on_change` with the names
+ * of the files that changed. An empty list means some changes were missed, so any file may have
+ * changed. This blocks the calling thread until the folder can't be watched any more.
+ *
+ * This is implemented separately for each platform in watch_directory_win32.cpp and
+ * watch_directory_posix.cpp.
+ */
+void watch_directory(
+    const std::filesystem::path &folder,
+    const std::function<void(std::span<const std::filesystem::path> filenames)> &on_change);
+
+}
+}
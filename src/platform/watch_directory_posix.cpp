@@ -0,0 +1,61 @@
+#include "watch_directory.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * There's no portable change notification, so modification times are polled this often
+ */
+static constexpr auto poll_interval = chrono::milliseconds{500};
+
+static map<fs::path, fs::file_time_type> list_files(const fs::path &folder, error_code &ec) {
+    auto files = map<fs::path, fs::file_time_type>{};
+    for (auto &entry : fs::directory_iterator{folder, ec}) {
+        auto entry_ec = error_code{};
+        if (entry.is_regular_file(entry_ec)) {
+            files[entry.path().filename()] = entry.last_write_time(entry_ec);
+        }
+    }
+    return files;
+}
+
+void gg::platform::watch_directory(
+    const fs::path &folder, const function<void(span<const fs::path> filenames)> &on_change) {
+    auto ec = error_code{};
+    auto files = list_files(folder, ec);
+    if (ec) {
+        SPDLOG_WARN("Failed to watch {} for changes ({})", folder.string(), ec.message());
+        return;
+    }
+
+    auto filenames = vector<fs::path>{};
+    while (true) {
+        this_thread::sleep_for(poll_interval);
+
+        auto current_files = list_files(folder, ec);
+        if (ec) {
+            SPDLOG_WARN("Stopped watching {} for changes ({})", folder.string(), ec.message());
+            break;
+        }
+
+        filenames.clear();
+        for (auto &[filename, write_time] : current_files) {
+            auto previous = files.find(filename);
+            if (previous == files.end() || previous->second != write_time) {
+                filenames.push_back(filename);
+            }
+        }
+        files = move(current_files);
+
+        if (!filenames.empty()) {
+            on_change(filenames);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#include "watch_directory.hpp"
+
+#include <spdlog/spdlog.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <string_view>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+void gg::platform::watch_directory(
+    const fs::path &folder, const function<void(span<const fs::path> filenames)> &on_change) {
+    auto handle = CreateFileW(folder.c_str(), FILE_LIST_DIRECTORY,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        SPDLOG_WARN("Failed to watch {} for changes ({})", folder.string(), GetLastError());
+        return;
+    }
+
+    auto buffer = vector<DWORD>(16 * 1024);
+    auto filenames = vector<fs::path>{};
+    while (true) {
+        DWORD bytes_returned = 0;
+        if (!ReadDirectoryChangesW(handle, buffer.data(), buffer.size() * sizeof(DWORD), false,
+                                   FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                   &bytes_returned, nullptr, nullptr)) {
+            SPDLOG_WARN("Stopped watching {} for changes ({})", folder.string(), GetLastError());
+            break;
+        }
+
+        // An empty result means the buffer overflowed, so no filenames are reported
+        filenames.clear();
+        for (auto offset = size_t{0}; offset < bytes_returned;) {
+            auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(
+                reinterpret_cast<const char *>(buffer.data()) + offset);
+            filenames.emplace_back(
+                wstring_view{info->FileName, info->FileNameLength / sizeof(wchar_t)});
+
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            offset += info->NextEntryOffset;
+        }
+
+        on_change(filenames);
+    }
+
+    CloseHandle(handle);
+}
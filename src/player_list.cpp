@@ -1,43 +1,45 @@
 #include "player_list.hpp"
 
+#include "auto_block.hpp"
 #include "config.hpp"
-
-#include <steam/isteamfriends.h>
-#include <steam/isteamnetworkingmessages.h>
-#include <steam/isteamuser.h>
-#include <steam/isteamutils.h>
-#include <steam/steamclientpublic.h>
+#include "encounters.hpp"
+#include "events.hpp"
+#include "fake_block.hpp"
+#include "fake_steam.hpp"
+#include "input.hpp"
+#include "network_monitor.hpp"
+#include "session_members.hpp"
+#include "steam.hpp"
+#include "telemetry.hpp"
+#include "trace.hpp"
 
 #include <elden-x/chr/world_chr_man.hpp>
 #include <elden-x/now_loading_helper.hpp>
+#include <steam/steamclientpublic.h>
 
+#include <chrono>
+#include <cmath>
 #include <codecvt>
+#include <format>
+#include <span>
+#include <string>
 
 using namespace std;
 
 vector<optional<gg::player_list_entry>> gg::player_list_entries = {};
+gg::player_list_view gg::player_list = {};
 
 static wstring_convert<codecvt_utf8_utf16<wchar_t>, wchar_t> utf16_convert;
 
 /**
  * Get a player's Steam profile avatar if available for quick visual identification
  */
-static shared_ptr<gg::renderer::texture> load_player_steam_avatar(CSteamID steam_id) {
+static shared_ptr<gg::renderer::texture> load_player_steam_avatar(uint64_t steam_id) {
     static vector<unsigned char> avatar_buffer(32 * 32 * 4);
 
-    auto avatar = SteamFriends()->GetSmallFriendAvatar(steam_id);
-    if (!avatar) {
-        return nullptr;
-    }
-
     unsigned int avatar_width;
     unsigned int avatar_height;
-    if (!SteamUtils()->GetImageSize(avatar, &avatar_width, &avatar_height)) {
-        return nullptr;
-    }
-
-    avatar_buffer.resize(avatar_width * avatar_height * 4);
-    if (!SteamUtils()->GetImageRGBA(avatar, avatar_buffer.data(), avatar_buffer.size())) {
+    if (!gg::steam::get_small_avatar(steam_id, avatar_buffer, avatar_width, avatar_height)) {
         return nullptr;
     }
 
@@ -45,94 +47,320 @@ static shared_ptr<gg::renderer::texture> load_player_steam_avatar(CSteamID steam
                                                     avatar_height);
 }
 
-void gg::update_player_list() {
-    if (config::debug) {
-        // When numpad 0 is pressed and debug mode is enabled, toggle some sample data for quickly
-        // testing the mod without going online
-        static bool show_test_data = false;
-        if (GetAsyncKeyState(VK_NUMPAD0) & 1) {
-            player_list_entries.clear();
-            show_test_data = !show_test_data;
-            if (show_test_data) {
-                auto avatar = load_player_steam_avatar(SteamUser()->GetSteamID());
-                player_list_entries.resize(3);
-                player_list_entries[0].emplace(nullptr, "Tom", "Tom", avatar,
-                                               k_EFriendRelationshipNone, 48);
-                player_list_entries[1].emplace(nullptr, "Bingus", "Bingus", avatar,
-                                               k_EFriendRelationshipIgnored, 31);
-                player_list_entries[2].emplace(nullptr, "Guts", "John Steamfriend", avatar,
-                                               k_EFriendRelationshipFriend, 93);
-            }
-        }
+/**
+ * Summarize a player's connection for the network details row
+ */
+static string format_network_details(const gg::network_monitor::peer_status &status) {
+    auto quality = [](float value) {
+        return value < 0.f ? string{"?"} : format("{:.0f}%", value * 100.f);
+    };
 
-        if (show_test_data) {
-            return;
+    auto details = format("Up {:.1f} KB/s ({:.0f}% of {:.0f} KB/s), down {:.1f} KB/s, "
+                          "quality {}/{}, queue {}ms",
+                          status.out_bytes_per_sec / 1000.f, status.uplink_utilization() * 100.f,
+                          status.send_rate_bytes_per_sec / 1000.f, status.in_bytes_per_sec / 1000.f,
+                          quality(status.quality_local), quality(status.quality_remote),
+                          status.queue_time_us / 1000);
+    if (status.congested()) {
+        details += ", uplink congested";
+    }
+    return details;
+}
+
+/**
+ * Copy out what the auto-block rules need to know about each player, so they can be evaluated on a
+ * background thread
+ */
+static void submit_auto_block_snapshot() {
+    auto snapshot = vector<gg::rules::player_facts>{};
+    for (auto &entry : gg::player_list_entries) {
+        if (!entry) {
+            continue;
         }
+
+        auto player = entry->player;
+        snapshot.push_back({
+            .steam_id = entry->steam_id,
+            .in_game_name = player ? utf16_convert.to_bytes(player->game_data->name_c_str)
+                                   : string{gg::fake_steam::get_in_game_name(entry->steam_id)},
+            .steam_name = gg::steam::get_persona_name(entry->steam_id),
+            .ping = entry->steam_ping.value,
+            .rune_level = static_cast<int>(player ? player->game_data->rune_level
+                                                  : gg::fake_steam::get_level(entry->steam_id)),
+        });
     }
+    gg::auto_block::submit(move(snapshot));
+}
 
+static gg::session_members::tracker session_members;
+static vector<gg::session_members::member> current_members;
+static bool session_loading = true;
+
+/**
+ * Read who's in each of the game's player slots into current_members
+ *
+ * @returns false if the game is on a loading screen, where players can't be read
+ */
+static bool read_session_members() {
     auto now_loading_helper = er::CS::CSNowLoadingHelper::instance();
-    if ((!now_loading_helper || !now_loading_helper->loaded1)) {
-        player_list_entries.clear();
+    auto world_chr_man = er::CS::WorldChrMan::instance();
+    if (!now_loading_helper || !now_loading_helper->loaded1 || !world_chr_man) {
+        return false;
+    }
+
+    auto &player_chr_set = world_chr_man->player_chr_set;
+    current_members.assign(static_cast<size_t>(player_chr_set.capacity()), {});
+    for (int slot = 0; slot < current_members.size(); slot++) {
+        auto player = player_chr_set.at(slot);
+        if (player && player->session_holder.network_session &&
+            (gg::config::show_yourself || player != world_chr_man->main_player)) {
+            current_members[slot] = {
+                player, player->session_holder.network_session->steam_id.ConvertToUint64()};
+        }
+    }
+    return true;
+}
+
+/**
+ * @returns the players that joined, left or were replaced in the game's session. While the game
+ * is loading, the previous members are kept rather than reported as leaving, so a loading screen
+ * doesn't look like everyone leaving and joining again.
+ */
+static span<const gg::session_members::event> update_session_members() {
+    session_loading = !read_session_members();
+    if (session_loading) {
+        return {};
+    }
+    return session_members.update(current_members);
+}
+
+/**
+ * @returns true if the game is on a loading screen, where players can't be read. The fake session
+ * never loads.
+ */
+static bool is_loading() { return !gg::fake_steam::active() && session_loading; }
+
+/**
+ * Pack the occupied slots into the view drawn by the overlay. The arrays are cleared rather than
+ * reallocated, so this doesn't allocate once they've grown to the session size. This only needs
+ * to happen when the players change, apart from the dead bits which are refreshed every frame.
+ */
+static void build_player_list_view(bool hidden) {
+    auto &view = gg::player_list;
+    view.entries.clear();
+    view.slots.clear();
+    view.steam_ids.clear();
+    view.avatars.clear();
+    view.dead.clear();
+
+    if (hidden) {
         return;
     }
 
-    auto world_chr_man = er::CS::WorldChrMan::instance();
-    if (!world_chr_man) {
-        player_list_entries.clear();
+    for (int i = 0; i < gg::player_list_entries.size(); i++) {
+        auto &entry = gg::player_list_entries[i];
+        if (!entry) {
+            continue;
+        }
+
+        view.entries.push_back(&*entry);
+        view.slots.push_back(i);
+        view.steam_ids.push_back(entry->steam_id);
+        view.avatars.push_back(entry->steam_avatar ? entry->steam_avatar->id() : ImTextureID{});
+        view.dead.push_back(entry->player && entry->player->game_data->hp == 0);
+    }
+}
+
+static void update_player_list_view_dead() {
+    auto &view = gg::player_list;
+    for (size_t i = 0; i < view.size(); i++) {
+        auto player = view.entries[i]->player;
+        auto dead = player && player->game_data->hp == 0;
+        if (dead && !view.dead[i]) {
+            gg::events::publish(gg::events::player_died{view.steam_ids[i], view.slots[i]});
+        }
+        view.dead[i] = dead;
+    }
+}
+
+/**
+ * Show how many times a player has been met before, and whether they had a bad connection
+ */
+static void load_encounter_badge(gg::player_list_entry &entry) {
+    auto encounter = gg::encounters::find(entry.steam_id);
+    if (!encounter) {
         return;
     }
 
-    player_list_entries.resize(world_chr_man->player_chr_set.capacity());
-    for (int i = 0; i < player_list_entries.size(); i++) {
-        auto player = world_chr_man->player_chr_set.at(i);
-        auto &entry = player_list_entries.at(i);
+    entry.encounter_loaded = true;
+    if (encounter->times_met == 0) {
+        return;
+    }
 
-        if (player && player->session_holder.network_session &&
-            (gg::config::show_yourself || player != world_chr_man->main_player)) {
-            auto steam_id = player->session_holder.network_session->steam_id;
+    auto badge = format("{}x", encounter->times_met);
+    if (encounter->average_ping && *encounter->average_ping > gg::config::high_ping) {
+        badge += " lag";
+    }
+    entry.encounter_badge = badge;
+    entry.encounter_blocked = encounter->blocked;
+}
 
-            // If this slot was previously empty or had a different player, construct a new
-            // entry for this player
-            if (!entry || entry->player != player) {
-                entry = gg::player_list_entry{};
-                entry->player = player;
+/**
+ * Set up a new entry when a player joins. Avatars and names are only loaded here, so they aren't
+ * loaded again for the same player after a loading screen.
+ */
+static void add_player(optional<gg::player_list_entry> &entry,
+                       int slot,
+                       er::CS::PlayerIns *player,
+                       uint64_t steam_id) {
+    entry = gg::player_list_entry{};
+    entry->player = player;
+    entry->steam_id = steam_id;
 
-                if (gg::config::show_steam_avatar) {
-                    entry->steam_avatar = load_player_steam_avatar(steam_id);
-                }
+    if (gg::config::show_steam_avatar) {
+        entry->steam_avatar = load_player_steam_avatar(steam_id);
+    }
 
-                if (gg::config::show_in_game_name) {
-                    entry->in_game_name = utf16_convert.to_bytes(player->game_data->name_c_str);
-                }
-            }
+    // Players in the fake session don't have a character to read their name from
+    auto in_game_name = player ? utf16_convert.to_bytes(player->game_data->name_c_str)
+                               : string{gg::fake_steam::get_in_game_name(steam_id)};
+    if (gg::config::show_in_game_name) {
+        entry->in_game_name = in_game_name;
+    }
 
-            if (gg::config::show_steam_name) {
-                entry->steam_name = SteamFriends()->GetFriendPersonaName(steam_id);
-            }
 
-            if (gg::config::show_ping) {
-                // Ping changes throughout a session, and is already free from Steam
-                auto steam_connection_status = SteamNetConnectionRealTimeStatus_t{};
-                auto steam_net_id = SteamNetworkingIdentity{};
-                steam_net_id.SetSteamID(steam_id);
-                SteamNetworkingMessages()->GetSessionConnectionInfo(steam_net_id, nullptr,
-                                                                    &steam_connection_status);
-
-                entry->steam_ping_cumulative_error +=
-                    steam_connection_status.m_nPing - entry->steam_ping;
-
-                // Only update ping if it's consistently far off, to avoid UI flickering
-                if (entry->steam_ping <= 0 || abs(entry->steam_ping_cumulative_error) > 100) {
-                    entry->steam_ping = steam_connection_status.m_nPing;
-                    entry->steam_ping_cumulative_error = 0;
-                }
+    auto event = gg::events::player_joined{.steam_id = steam_id, .slot = slot};
+    event.set_in_game_name(in_game_name);
+    gg::events::publish(event);
+}
+
+static void remove_player(optional<gg::player_list_entry> &entry, int slot) {
+    if (entry) {
+        gg::events::publish(gg::events::player_left{entry->steam_id, slot});
+    }
+    entry.reset();
+}
+
+/**
+ * @returns true if the players in the list changed, and the view needs to be built again
+ */
+static bool update_player_list_entries() {
+    // When numpad 0 is pressed and debug mode is enabled, switch to a fake session for testing
+    // the mod without going online
+    if (gg::config::debug && gg::input::pressed(ImGuiKey_Keypad0)) {
+        gg::player_list_entries.clear();
+        session_members.reset();
+        gg::fake_steam::set_active(!gg::fake_steam::active());
+        return true;
+    }
+
+    gg::expire_temporary_blocks();
+
+    static bool was_loading = false;
+    auto events =
+        gg::fake_steam::active() ? gg::fake_steam::update() : update_session_members();
+    auto loading = is_loading();
+    auto changed = !events.empty() || loading != was_loading;
+    was_loading = loading;
+
+    // The entries are kept during loading screens, but the players in them can't be read
+    if (loading) {
+        return changed;
+    }
+
+    for (auto &event : events) {
+        if (event.slot >= gg::player_list_entries.size()) {
+            gg::player_list_entries.resize(event.slot + 1);
+        }
+
+        auto &entry = gg::player_list_entries[event.slot];
+        auto player = static_cast<er::CS::PlayerIns *>(event.player);
+        switch (event.type) {
+        case gg::session_members::event_type::join:
+            add_player(entry, event.slot, player, event.steam_id);
+            break;
+        case gg::session_members::event_type::replace:
+            // The same player gets a new character after a loading screen
+            if (entry && entry->steam_id == event.steam_id) {
+                entry->player = player;
+            } else {
+                remove_player(entry, event.slot);
+                add_player(entry, event.slot, player, event.steam_id);
             }
+            break;
+        case gg::session_members::event_type::leave:
+            remove_player(entry, event.slot);
+            break;
+        }
+    }
+
+    for (auto &entry : gg::player_list_entries) {
+        if (!entry) {
+            continue;
+        }
+
+        auto steam_id = CSteamID{entry->steam_id};
+
+        if (gg::config::show_steam_name) {
+            entry->steam_name = gg::steam::get_persona_name(entry->steam_id);
+        }
+
+        // Ping changes throughout a session, and is sampled by the network monitor. It's always
+        // updated since the ping and jitter columns and the auto-block rules all use it.
+        auto status = gg::network_monitor::get(entry->steam_id);
+        auto ping = status ? status->ping : -1;
+        if (status) {
+            entry->connection_quality_local = status->quality_local;
+            entry->connection_quality_remote = status->quality_remote;
+        }
+
+        entry->steam_ping.update(ping);
 
-            if (gg::config::show_steam_relationship) {
-                entry->steam_relationship = SteamFriends()->GetFriendRelationship(steam_id);
+        auto now = chrono::steady_clock::now();
+        if (entry->steam_ping.sample(ping, now)) {
+            if (ping > 0) {
+                gg::events::publish(gg::events::ping_sampled{entry->steam_id, ping});
             }
-        } else {
-            entry.reset();
+            if (status) {
+                entry->network_details = format_network_details(*status);
+            }
+        }
+
+        entry->level_text.set(entry->player ? entry->player->game_data->rune_level
+                                            : gg::fake_steam::get_level(entry->steam_id));
+        entry->ping_text.set(entry->steam_ping.value);
+        entry->jitter_text.set(static_cast<int>(roundf(entry->steam_ping.jitter)));
+        entry->session_time_text.set(static_cast<int>(
+            chrono::duration_cast<chrono::seconds>(now - entry->join_time).count()));
+
+        if (gg::config::show_steam_relationship) {
+            entry->steam_relationship = gg::get_friend_relationship(steam_id);
+        }
+
+        // The history is read on the event thread when the join is recorded, so the badge shows
+        // up a frame or two after the player does
+        if (!entry->encounter_loaded) {
+            load_encounter_badge(*entry);
         }
     }
-}
\ No newline at end of file
+
+    if (gg::auto_block::wants_snapshot()) {
+        submit_auto_block_snapshot();
+    }
+
+    return changed;
+}
+
+void gg::update_player_list() {
+    GG_TRACE_ZONE("update_player_list");
+
+    if (update_player_list_entries()) {
+        build_player_list_view(is_loading());
+        gg::network_monitor::set_peers(gg::player_list.steam_ids);
+    }
+    update_player_list_view_dead();
+
+    if (!is_loading()) {
+        gg::telemetry::update();
+    }
+}
@@ -1,12 +1,19 @@
 #pragma once
 
+#include "gui/text_cache.hpp"
+#include "ping_smoother.hpp"
 #include "renderer/texture.hpp"
 
 #include <elden-x/chr/player.hpp>
 
+#include <imgui.h>
+
 #include <steam/isteamfriends.h>
 
+#include <chrono>
+#include <format>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,15 +25,39 @@ namespace gg {
  */
 struct player_list_entry {
     er::CS::PlayerIns *player{nullptr};
-    std::string in_game_name;
-    std::string steam_name;
+    uint64_t steam_id{0};
+    gg::gui::cached_text in_game_name;
+    gg::gui::cached_text steam_name;
     std::shared_ptr<gg::renderer::texture> steam_avatar;
     EFriendRelationship steam_relationship{k_EFriendRelationshipNone};
-    int steam_ping{-1};
-    int steam_ping_cumulative_error{0};
+    gg::ping_smoother steam_ping;
 
     float connection_quality_local{-1.f};
     float connection_quality_remote{-1.f};
+
+    /**
+     * Bandwidth, connection quality and congestion, shown when network details are toggled on
+     */
+    gg::gui::cached_text network_details;
+
+    /**
+     * How many times this player has been met before, and whether they were blocked last time
+     */
+    gg::gui::cached_text encounter_badge;
+    bool encounter_blocked{false};
+    bool encounter_loaded{false};
+
+    std::chrono::steady_clock::time_point join_time{std::chrono::steady_clock::now()};
+
+    /**
+     * Numbers shown in the player list, formatted only when they change
+     */
+    gg::gui::cached_number level_text{[](int level) { return std::format("Level {}", level); }};
+    gg::gui::cached_number ping_text{[](int ping) { return std::format("{}ms", ping); }};
+    gg::gui::cached_number jitter_text{
+        [](int jitter) { return std::format("\xc2\xb1{}ms", jitter); }};
+    gg::gui::cached_number session_time_text{
+        [](int seconds) { return std::format("{}:{:02}", seconds / 60, seconds % 60); }};
 };
 
 /**
@@ -36,6 +67,25 @@ struct player_list_entry {
  */
 extern std::vector<std::optional<player_list_entry>> player_list_entries;
 
+/**
+ * The occupied slots of player_list_entries packed into parallel arrays, rebuilt by
+ * update_player_list(). Everything the overlay needs from the game's player data is copied out
+ * here once per update, so drawing the list is a linear scan with no copies or pointer chasing
+ * into the game.
+ */
+struct player_list_view {
+    std::vector<const player_list_entry *> entries;
+    std::vector<int> slots;
+    std::vector<uint64_t> steam_ids;
+    std::vector<ImTextureID> avatars;
+    std::vector<bool> dead;
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+};
+
+extern player_list_view player_list;
+
 /**
  * Update the list of player info based on the current players in the session
  */
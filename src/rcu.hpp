@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace gg {
+
+/**
+ * Minimal read-copy-update pointer for data that's read constantly from arbitrary threads and
+ * replaced rarely. Readers never lock, and only touch a reader counter and the current pointer.
+ * Writers publish a new immutable value, then wait for readers still using the old one before
+ * freeing it.
+ */
+template <typename T>
+class rcu_ptr {
+private:
+    struct alignas(64) reader_count {
+        std::atomic<unsigned int> value{0};
+    };
+
+    std::atomic<const T *> current;
+    std::atomic<unsigned int> epoch{0};
+    mutable reader_count readers[2];
+    std::mutex write_mutex;
+
+    /**
+     * Wait until every reader that started before the last publish has finished. New readers are
+     * pointed at the other counter first, so this can't be starved by a steady stream of lookups.
+     */
+    void synchronize() {
+        for (int i = 0; i < 2; i++) {
+            auto index = epoch.fetch_add(1) & 1;
+            while (readers[index].value.load() != 0) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    const T *swap(std::unique_ptr<const T> next) {
+        auto previous = current.exchange(next.release());
+        synchronize();
+        return previous;
+    }
+
+public:
+    class reader {
+    private:
+        const rcu_ptr &rcu;
+        unsigned int index;
+        const T *value;
+
+    public:
+        explicit reader(const rcu_ptr &rcu)
+            : rcu(rcu),
+              index(rcu.epoch.load() & 1) {
+            rcu.readers[index].value.fetch_add(1);
+            value = rcu.current.load();
+        }
+
+        reader(const reader &) = delete;
+        reader &operator=(const reader &) = delete;
+
+        ~reader() { rcu.readers[index].value.fetch_sub(1); }
+
+        const T &operator*() const { return *value; }
+        const T *operator->() const { return value; }
+    };
+
+    rcu_ptr()
+        : current(new T{}) {}
+
+    explicit rcu_ptr(std::unique_ptr<const T> value)
+        : current(value.release()) {}
+
+    rcu_ptr(const rcu_ptr &) = delete;
+    rcu_ptr &operator=(const rcu_ptr &) = delete;
+
+    ~rcu_ptr() { delete current.load(); }
+
+    /**
+     * Get a guard that keeps the current value alive until it goes out of scope
+     */
+    reader read() const { return reader{*this}; }
+
+    /**
+     * Replace the current value, freeing the previous one once no readers are using it
+     */
+    void publish(std::unique_ptr<const T> next) {
+        auto lock = std::lock_guard{write_mutex};
+        delete swap(std::move(next));
+    }
+
+    /**
+     * Build a new value from the current one and publish it. Writers are serialized, so no update
+     * is lost. If make_next returns nullptr, the current value is kept.
+     *
+     * @returns true if a new value was published
+     */
+    template <typename F>
+    bool update(F &&make_next) {
+        auto lock = std::lock_guard{write_mutex};
+        std::unique_ptr<const T> next = make_next(*current.load());
+        if (!next) {
+            return false;
+        }
+        delete swap(std::move(next));
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,158 @@
+#include "relationship_cache.hpp"
+
+#include <steam/steam_api.h>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+/**
+ * The cache only needs to hold players in the current session plus a few recent ones, so it's a
+ * small direct-mapped table. Each entry packs the account ID, a generation number, and the
+ * relationship into one 64 bit word, so lookups and updates from any thread are a single atomic
+ * load or store.
+ */
+static constexpr size_t cache_size = 64;
+static constexpr unsigned int cache_bits = 6;
+static_assert(cache_size == 1 << cache_bits);
+
+static array<atomic<uint64_t>, cache_size> entries;
+
+/**
+ * Bumped to invalidate every entry at once. Entries from earlier generations are ignored.
+ */
+static atomic<uint32_t> generation{1};
+
+/**
+ * Bumped each time an entry is invalidated, so an answer from Steam that was requested before the
+ * invalidation isn't stored after it
+ */
+static array<atomic<uint32_t>, cache_size> invalidations;
+
+static constexpr uint32_t generation_mask = 0xffffff;
+
+/**
+ * Only normal user accounts are cached, since they all share the same upper 32 bits and can be
+ * identified by account ID alone
+ */
+static const auto individual_id_prefix =
+    CSteamID{0u, k_EUniversePublic, k_EAccountTypeIndividual}.ConvertToUint64() >> 32;
+
+static inline bool is_cacheable(CSteamID steam_id) {
+    return steam_id.ConvertToUint64() >> 32 == individual_id_prefix;
+}
+
+static inline size_t index_for(uint32_t account_id) {
+    return (account_id * 0x9e3779b9u) >> (32 - cache_bits);
+}
+
+static inline atomic<uint64_t> &entry_for(uint32_t account_id) {
+    return entries[index_for(account_id)];
+}
+
+static inline uint64_t pack(uint32_t account_id, uint32_t generation, EFriendRelationship value) {
+    return static_cast<uint64_t>(account_id) << 32 |
+           static_cast<uint64_t>(generation & generation_mask) << 8 |
+           static_cast<uint8_t>(value);
+}
+
+optional<EFriendRelationship> gg::relationship_cache::get(CSteamID steam_id) {
+    if (!is_cacheable(steam_id)) {
+        return nullopt;
+    }
+
+    auto account_id = steam_id.GetAccountID();
+    auto entry = entry_for(account_id).load(memory_order_acquire);
+    if (entry >> 32 != account_id ||
+        ((entry >> 8) & generation_mask) !=
+            (generation.load(memory_order_acquire) & generation_mask)) {
+        return nullopt;
+    }
+
+    return static_cast<EFriendRelationship>(entry & 0xff);
+}
+
+uint64_t gg::relationship_cache::get_generation(CSteamID steam_id) {
+    if (!is_cacheable(steam_id)) {
+        return 0;
+    }
+
+    auto index = index_for(steam_id.GetAccountID());
+    return static_cast<uint64_t>(invalidations[index].load()) << 32 | generation.load();
+}
+
+void gg::relationship_cache::put(CSteamID steam_id, EFriendRelationship value,
+                                 uint64_t current_generation) {
+    if (!is_cacheable(steam_id) || get_generation(steam_id) != current_generation) {
+        return;
+    }
+
+    auto account_id = steam_id.GetAccountID();
+    auto &entry = entry_for(account_id);
+    auto packed = pack(account_id, static_cast<uint32_t>(current_generation), value);
+    entry.store(packed);
+
+    // If the entry was invalidated while it was being stored, the invalidation may have cleared
+    // it first, so clear it again
+    if (get_generation(steam_id) != current_generation) {
+        entry.compare_exchange_strong(packed, 0);
+    }
+}
+
+void gg::relationship_cache::invalidate(CSteamID steam_id) {
+    if (!is_cacheable(steam_id)) {
+        return;
+    }
+
+    auto account_id = steam_id.GetAccountID();
+    invalidations[index_for(account_id)].fetch_add(1);
+
+    auto &entry = entry_for(account_id);
+    auto current = entry.load();
+    if (current >> 32 == account_id) {
+        entry.compare_exchange_strong(current, 0);
+    }
+}
+
+void gg::relationship_cache::invalidate_all() {
+    // Generation 0 is reserved so that zeroed entries are never valid
+    if (((generation.fetch_add(1) + 1) & generation_mask) == 0) {
+        generation.fetch_add(1);
+    }
+}
+
+/**
+ * Listens for Steam notifying us that the user added, removed, or blocked a friend, or that
+ * relationships may have changed while Steam was disconnected
+ */
+struct relationship_listener {
+    STEAM_CALLBACK(relationship_listener, on_persona_state_change, PersonaStateChange_t);
+    STEAM_CALLBACK(relationship_listener, on_steam_servers_connected, SteamServersConnected_t);
+};
+
+void relationship_listener::on_persona_state_change(PersonaStateChange_t *change) {
+    if (change->m_nChangeFlags & k_EPersonaChangeRelationshipChanged) {
+        gg::relationship_cache::invalidate(change->m_ulSteamID);
+    }
+}
+
+void relationship_listener::on_steam_servers_connected(SteamServersConnected_t *) {
+    gg::relationship_cache::invalidate_all();
+}
+
+static unique_ptr<relationship_listener> listener;
+
+void gg::relationship_cache::initialize() { listener = make_unique<relationship_listener>(); }
+
+gg::memory::usage gg::relationship_cache::memory_usage() {
+    auto current = generation.load(memory_order_relaxed) & generation_mask;
+    auto result = memory::usage{.bytes = sizeof(entries) + sizeof(invalidations)};
+    for (auto &entry : entries) {
+        if (((entry.load(memory_order_relaxed) >> 8) & generation_mask) == current) {
+            result.count++;
+        }
+    }
+    return result;
+}
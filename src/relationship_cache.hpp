@@ -0,0 +1,48 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <steam/isteamfriends.h>
+#include <steam/steamclientpublic.h>
+
+#include <cstdint>
+#include <optional>
+
+namespace gg {
+namespace relationship_cache {
+
+/**
+ * Register for Steam callbacks that invalidate cached relationships. Must be called after the
+ * Steam API is initialized.
+ */
+void initialize();
+
+/**
+ * @returns the cached Steam relationship with the given player, if there is one. Safe to call
+ * from any thread.
+ */
+std::optional<EFriendRelationship> get(CSteamID);
+
+/**
+ * @returns a number that changes whenever the given player's cached relationship is invalidated.
+ * Take it before asking Steam, and pass it to put() with the answer.
+ */
+uint64_t get_generation(CSteamID);
+
+/**
+ * Cache a relationship, unless it was invalidated since `generation` was taken, in which case
+ * Steam's answer may already be out of date
+ */
+void put(CSteamID, EFriendRelationship, uint64_t generation);
+
+void invalidate(CSteamID);
+
+void invalidate_all();
+
+/**
+ * @returns how many relationships are cached, and the size of the table
+ */
+memory::usage memory_usage();
+
+}
+}
@@ -1,5 +1,9 @@
 #include "renderer.hpp"
 
+#include "../input.hpp"
+#include "../memory.hpp"
+#include "../trace.hpp"
+
 #include <elden-x/graphics.hpp>
 #include <elden-x/task.hpp>
 #include <elden-x/window.hpp>
@@ -40,6 +44,7 @@ private:
      * Callback to overlay rendering methods passed from dllmain
      */
     function<void()> initialize_callback;
+    function<void()> update_callback;
     function<void()> render_callback;
 
     struct render_target {
@@ -151,6 +156,7 @@ public:
 
         setup_render_targets();
 
+        gg::memory::track_imgui_allocations();
         ImGui::CreateContext();
         ImGui::GetIO().ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
@@ -182,13 +188,19 @@ public:
 public:
     render_task() {}
 
-    render_task(function<void()> initialize_callback, function<void()> render_callback)
+    render_task(function<void()> initialize_callback,
+                function<void()> update_callback,
+                function<void()> render_callback)
         : initialize_callback(initialize_callback),
+          update_callback(update_callback),
           render_callback(render_callback) {}
 
     virtual void execute(er::FD4::task_data *data,
                          er::FD4::task_group group,
                          er::FD4::task_affinity affinity) override {
+        GG_TRACE_THREAD("DrawBegin task");
+        GG_TRACE_ZONE("render_task::execute");
+
         auto gxglobals = er::GXBS::globals::instance();
         auto command_queue = gxglobals->get_command_queue();
         auto swap_chain = gxglobals->get_swap_chain();
@@ -198,6 +210,8 @@ public:
         if (!initialized) initialize();
         if (!initialized) return;
 
+        update_callback();
+
         ImGui_ImplDX12_NewFrame();
         ImGui_ImplWin32_NewFrame();
 
@@ -223,7 +237,10 @@ public:
         command_list->OMSetRenderTargets(1, &render_target.descriptor_handle, FALSE, nullptr);
         command_list->SetDescriptorHeaps(1, &render_descriptor_heap);
 
-        ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), command_list);
+        {
+            GG_TRACE_ZONE("ImGui_ImplDX12_RenderDrawData");
+            ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), command_list);
+        }
 
         resource_barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
         resource_barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
@@ -239,13 +256,15 @@ public:
 /**
  * WNDPROC callback
  *
- * Handles ImGui events, then defers the the game's default WNDPROC
+ * Handles ImGui events, then defers the the game's default WNDPROC. Messages the overlay doesn't
+ * need right now aren't passed to ImGui at all.
  *
  * https://learn.microsoft.com/en-us/windows/win32/api/winuser/nc-winuser-wndproc
  */
 static WNDPROC wndproc;
 static LRESULT wndproc_hook(HWND hwnd, unsigned int msg, WPARAM wparam, LPARAM lparam) {
-    if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam)) {
+    if (gg::input::handle_message(msg, wparam, lparam) &&
+        ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam)) {
         return true;
     }
 
@@ -287,12 +306,18 @@ void gg::renderer::impl::free_descriptor(gg::renderer::impl::descriptor_pair pai
     free_indexes.push_back(index);
 }
 
+gg::renderer::descriptor_usage gg::renderer::get_descriptor_usage() {
+    return {static_cast<unsigned int>(srv_descriptor_count - free_indexes.size()),
+            srv_descriptor_count};
+}
+
 void gg::renderer::initialize(function<void()> initialize_callback,
+                              function<void()> update_callback,
                               function<void()> render_callback) {
     auto hwnd = er::CS::CSWindow::instance()->hwnd;
     wndproc = (WNDPROC)SetWindowLongPtrW(hwnd, GWLP_WNDPROC, (LONG_PTR)wndproc_hook);
 
-    task = render_task{initialize_callback, render_callback};
+    task = render_task{initialize_callback, update_callback, render_callback};
     er::CS::CSTask::instance()->register_task(er::FD4::task_group::DrawBegin, task);
 
     kiero::init(kiero::RenderType::D3D12);
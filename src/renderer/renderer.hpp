@@ -18,11 +18,23 @@ void free_descriptor(descriptor_pair);
 
 }
 
+struct descriptor_usage {
+    unsigned int used;
+    unsigned int capacity;
+};
+
+/**
+ * @returns how many descriptors in the overlay's shader resource heap are in use, out of how many
+ */
+descriptor_usage get_descriptor_usage();
+
 /**
  * Hooks the rendering of the game and sets up custom UI callback that can render stuff using Dear
- * ImGui
+ * ImGui. The update callback is called each frame before ImGui starts the frame.
  */
-void initialize(std::function<void()> initialize_callback, std::function<void()> render_callback);
+void initialize(std::function<void()> initialize_callback,
+                std::function<void()> update_callback,
+                std::function<void()> render_callback);
 
 }
 }
@@ -17,6 +17,23 @@
 using namespace std;
 namespace fs = std::filesystem;
 
+static gg::memory::usage textures_usage;
+
+size_t gg::renderer::impl::track_texture(ID3D12Resource *resource) {
+    auto desc = resource->GetDesc();
+    auto info = gg::renderer::impl::device->GetResourceAllocationInfo(0, 1, &desc);
+    textures_usage.count++;
+    textures_usage.bytes += info.SizeInBytes;
+    return info.SizeInBytes;
+}
+
+void gg::renderer::impl::untrack_texture(size_t memory_size) {
+    textures_usage.count--;
+    textures_usage.bytes -= memory_size;
+}
+
+gg::memory::usage gg::renderer::texture_memory() { return textures_usage; }
+
 shared_ptr<gg::renderer::texture> gg::renderer::load_texture_from_raw_data(
     unsigned char *image_data, int width, int height) {
     auto &device = gg::renderer::impl::device;
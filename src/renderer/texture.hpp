@@ -2,6 +2,8 @@
 
 #include "renderer.hpp"
 
+#include "../memory.hpp"
+
 #include <d3d12.h>
 
 #include <imgui.h>
@@ -19,6 +21,23 @@ namespace renderer {
 
 class texture;
 
+namespace impl {
+
+/**
+ * Add a texture to the totals returned by texture_memory()
+ *
+ * @returns the size of the texture in video memory
+ */
+size_t track_texture(ID3D12Resource *resource);
+void untrack_texture(size_t memory_size);
+
+}
+
+/**
+ * @returns how many textures are loaded, and how much video memory they use
+ */
+memory::usage texture_memory();
+
 /**
  * Simple helper function to load a DX12 texture from 8 bit RGBA pixels already stored in memory
  */
@@ -48,6 +67,7 @@ private:
     gg::renderer::impl::descriptor_pair desc;
     ID3D12Resource *resource;
     ImVec2 size_vector;
+    size_t memory_size_bytes;
 
 public:
     texture(ID3D12Resource *resource, int width, int height)
@@ -55,11 +75,13 @@ public:
           size_vector((float)width, (float)height) {
         desc = gg::renderer::impl::alloc_descriptor();
         resource->AddRef();
+        memory_size_bytes = gg::renderer::impl::track_texture(resource);
     };
 
     texture(texture &) = delete;
 
     ~texture() {
+        gg::renderer::impl::untrack_texture(memory_size_bytes);
         gg::renderer::impl::free_descriptor(desc);
         resource->Release();
     }
@@ -71,6 +93,11 @@ public:
     const ImVec2 &size() { return size_vector; }
     ImTextureID id() { return desc.second.ptr; }
 
+    /**
+     * Video memory used by the texture, as reported by GetResourceAllocationInfo()
+     */
+    size_t memory_size() const { return memory_size_bytes; }
+
     friend std::shared_ptr<texture> gg::renderer::load_texture_from_raw_data(
         unsigned char *image_data, int width, int height);
 };
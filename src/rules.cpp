@@ -0,0 +1,293 @@
+#include "rules.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <limits>
+#include <optional>
+
+using namespace std;
+
+/**
+ * Rule indexes are stored in 16 bits in each instruction
+ */
+static constexpr size_t max_rules = numeric_limits<uint16_t>::max();
+
+/**
+ * Split a rule into whitespace-separated tokens. A quoted token can contain spaces, and is
+ * returned without the quotes.
+ */
+static optional<vector<string_view>> tokenize(string_view text) {
+    auto tokens = vector<string_view>{};
+    size_t i = 0;
+    while (i < text.size()) {
+        if (isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+            continue;
+        }
+
+        if (text[i] == '"') {
+            auto end = text.find('"', i + 1);
+            if (end == string_view::npos) {
+                return nullopt;
+            }
+            tokens.push_back(text.substr(i + 1, end - i - 1));
+            i = end + 1;
+            continue;
+        }
+
+        auto start = i;
+        while (i < text.size() && !isspace(static_cast<unsigned char>(text[i]))) {
+            i++;
+        }
+        tokens.push_back(text.substr(start, i - start));
+    }
+    return tokens;
+}
+
+static optional<int32_t> parse_int(string_view token) {
+    int32_t value;
+    auto [end, ec] = from_chars(token.data(), token.data() + token.size(), value);
+    if (ec != errc{} || end != token.data() + token.size()) {
+        return nullopt;
+    }
+    return value;
+}
+
+/**
+ * Parse a duration such as "20", "20s", or "5m" into milliseconds
+ */
+static optional<int32_t> parse_duration_ms(string_view token) {
+    auto multiplier = 1000;
+    if (token.ends_with('s')) {
+        token.remove_suffix(1);
+    } else if (token.ends_with('m')) {
+        token.remove_suffix(1);
+        multiplier = 60 * 1000;
+    }
+
+    auto value = parse_int(token);
+    if (!value || *value < 0 || *value > numeric_limits<int32_t>::max() / multiplier) {
+        return nullopt;
+    }
+    return *value * multiplier;
+}
+
+static string to_lower(string_view text) {
+    auto result = string{text};
+    ranges::transform(result, result.begin(),
+                      [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return result;
+}
+
+/**
+ * Match a name against a pattern where * matches any run of characters and ? matches any single
+ * character
+ */
+static bool glob_match(string_view pattern, string_view name) {
+    size_t p = 0, n = 0;
+    auto star = string_view::npos;
+    size_t star_n = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            p++;
+            n++;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            star_n = n;
+        } else if (star != string_view::npos) {
+            p = star + 1;
+            n = ++star_n;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        p++;
+    }
+    return p == pattern.size();
+}
+
+bool gg::rules::compile(string_view name, string_view text, program &out) {
+    auto invalid = [&](string_view reason) {
+        SPDLOG_WARN("Invalid rule \"{} = {}\": {}", name, text, reason);
+        return false;
+    };
+
+    if (out.rule_names.size() >= max_rules) {
+        return invalid("too many rules");
+    }
+
+    auto tokens = tokenize(text);
+    if (!tokens) {
+        return invalid("unterminated quote");
+    }
+
+    auto rule = static_cast<uint16_t>(out.rule_names.size());
+    auto instructions = vector<instruction>{};
+    auto patterns = vector<string>{};
+    auto timer_count = out.timer_count;
+
+    auto it = tokens->begin();
+    auto remaining = [&] { return static_cast<size_t>(tokens->end() - it); };
+
+    while (true) {
+        if (remaining() < 3) {
+            return invalid("expected a condition");
+        }
+
+        auto subject = *it++;
+        auto op = *it++;
+        auto ins = instruction{.rule = rule};
+
+        if ((subject == "ping" || subject == "level") && (op == ">" || op == "<")) {
+            auto value = parse_int(*it++);
+            if (!value) {
+                return invalid("expected a number");
+            }
+            if (subject == "ping") {
+                ins.op = op == ">" ? opcode::ping_above : opcode::ping_below;
+            } else {
+                ins.op = op == ">" ? opcode::level_above : opcode::level_below;
+            }
+            ins.a = *value;
+
+            if (remaining() >= 2 && *it == "for") {
+                it++;
+                auto duration = parse_duration_ms(*it++);
+                if (!duration) {
+                    return invalid("expected a duration");
+                }
+                ins.sustain_ms = *duration;
+                ins.timer = static_cast<uint32_t>(timer_count++);
+            }
+        } else if (subject == "level" && op == "outside") {
+            auto range = *it++;
+            auto dash = range.find('-');
+            auto min = dash == string_view::npos ? nullopt : parse_int(range.substr(0, dash));
+            auto max = dash == string_view::npos ? nullopt : parse_int(range.substr(dash + 1));
+            if (!min || !max || *min > *max) {
+                return invalid("expected a range such as 1-713");
+            }
+            ins.op = opcode::level_outside;
+            ins.a = *min;
+            ins.b = *max;
+        } else if (subject == "name" && op == "matches") {
+            ins.op = opcode::name_matches;
+            ins.a = static_cast<int32_t>(out.patterns.size() + patterns.size());
+            patterns.push_back(to_lower(*it++));
+        } else {
+            return invalid("unknown condition");
+        }
+
+        instructions.push_back(ins);
+
+        if (remaining() > 0 && *it == "and") {
+            it++;
+            continue;
+        }
+        break;
+    }
+
+    if (remaining() != 2 || *it != "=>") {
+        return invalid("expected \"=> block\" or \"=> warn\"");
+    }
+    auto action_name = *++it;
+    auto act = action::warn;
+    if (action_name == "block") {
+        act = action::block;
+    } else if (action_name != "warn") {
+        return invalid("unknown action");
+    }
+
+    instructions.push_back({.op = opcode::fire, .act = act, .rule = rule});
+
+    auto next_rule = static_cast<uint32_t>(out.instructions.size() + instructions.size());
+    for (auto &ins : instructions) {
+        ins.next_rule = next_rule;
+    }
+
+    out.instructions.insert(out.instructions.end(), instructions.begin(), instructions.end());
+    out.patterns.insert(out.patterns.end(), make_move_iterator(patterns.begin()),
+                        make_move_iterator(patterns.end()));
+    out.rule_names.emplace_back(name);
+    out.timer_count = timer_count;
+    return true;
+}
+
+gg::rules::evaluator::evaluator(const program &rules)
+    : rules(rules) {}
+
+void gg::rules::evaluator::evaluate(span<const player_facts> snapshot, int64_t now_ms,
+                                    vector<match> &out) {
+    pass++;
+
+    auto &instructions = rules.instructions;
+    for (auto &facts : snapshot) {
+        auto &state = players[facts.steam_id];
+        if (state.last_pass == 0) {
+            state.timers.resize(rules.timer_count, {now_ms, 0});
+            state.matched.resize(rules.rule_names.size());
+        }
+        state.last_pass = pass;
+
+        auto matched = vector<bool>(rules.rule_names.size());
+
+        size_t pc = 0;
+        while (pc < instructions.size()) {
+            auto &ins = instructions[pc];
+
+            auto passed = false;
+            switch (ins.op) {
+            case opcode::ping_above:
+                passed = facts.ping > ins.a;
+                break;
+            case opcode::ping_below:
+                passed = facts.ping >= 0 && facts.ping < ins.a;
+                break;
+            case opcode::level_above:
+                passed = facts.rune_level > ins.a;
+                break;
+            case opcode::level_below:
+                passed = facts.rune_level < ins.a;
+                break;
+            case opcode::level_outside:
+                passed = facts.rune_level < ins.a || facts.rune_level > ins.b;
+                break;
+            case opcode::name_matches: {
+                auto &pattern = rules.patterns[ins.a];
+                passed = glob_match(pattern, facts.in_game_name) ||
+                         glob_match(pattern, facts.steam_name);
+                break;
+            }
+            case opcode::fire:
+                matched[ins.rule] = true;
+                if (!state.matched[ins.rule]) {
+                    out.push_back({facts.steam_id, ins.rule, ins.act});
+                }
+                pc++;
+                continue;
+            }
+
+            // A sustained condition passes once it's been true on every evaluation for long
+            // enough. If it wasn't evaluated on the previous pass because an earlier condition
+            // failed, it isn't known to have held in between, so its timer starts over.
+            if (ins.sustain_ms > 0) {
+                auto &timer = state.timers[ins.timer];
+                if (passed && timer.last_pass + 1 != pass) {
+                    timer.since = now_ms;
+                }
+                timer.last_pass = passed ? pass : 0;
+                passed = passed && now_ms - timer.since >= ins.sustain_ms;
+            }
+
+            pc = passed ? pc + 1 : ins.next_rule;
+        }
+
+        state.matched = move(matched);
+    }
+
+    erase_if(players, [&](auto &entry) { return entry.second.last_pass != pass; });
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gg {
+namespace rules {
+
+enum class action : uint8_t {
+    warn,
+    block,
+};
+
+enum class opcode : uint8_t {
+    ping_above,
+    ping_below,
+    level_above,
+    level_below,
+    level_outside,
+    name_matches,
+
+    /**
+     * Reached only if every condition of a rule passed
+     */
+    fire,
+};
+
+/**
+ * A single step of a compiled program. Conditions of a rule are laid out one after another and
+ * followed by a fire instruction, and a condition that fails jumps straight to the first
+ * instruction of the next rule.
+ */
+struct instruction {
+    opcode op{opcode::fire};
+    action act{action::warn};
+    uint16_t rule{0};
+
+    /**
+     * Index of the first instruction of the next rule
+     */
+    uint32_t next_rule{0};
+
+    /**
+     * Operands: a threshold or range for numeric conditions, or an index into the program's
+     * patterns for name_matches
+     */
+    int32_t a{0};
+    int32_t b{0};
+
+    /**
+     * How long the condition must hold before it passes, in milliseconds, or 0 to pass as soon as
+     * it's true. Sustained conditions have their own timer slot for each player.
+     */
+    int32_t sustain_ms{0};
+    uint32_t timer{0};
+};
+
+/**
+ * Rules from the [rules] section of ergg.ini, compiled into a flat list of instructions
+ */
+struct program {
+    std::vector<instruction> instructions;
+    std::vector<std::string> patterns;
+    std::vector<std::string> rule_names;
+    size_t timer_count{0};
+
+    bool empty() const { return rule_names.empty(); }
+};
+
+/**
+ * Parse a rule such as "ping > 300 for 20s and level < 30 => block" and append it to the program.
+ * Logs a warning and leaves the program unchanged if the rule is invalid.
+ *
+ * @returns true if the rule was added
+ */
+bool compile(std::string_view name, std::string_view text, program &out);
+
+/**
+ * What the rules need to know about a player. Names are lowercased ASCII so matching them is a
+ * plain comparison.
+ */
+struct player_facts {
+    uint64_t steam_id;
+    std::string in_game_name;
+    std::string steam_name;
+    int ping;
+    int rune_level;
+};
+
+struct match {
+    uint64_t steam_id;
+    uint16_t rule;
+    action act;
+};
+
+/**
+ * Runs a program against successive snapshots of the player list, remembering how long sustained
+ * conditions have held for each player. A rule fires once when it starts matching a player, and
+ * can fire again only after it stops matching them.
+ */
+class evaluator {
+private:
+    struct timer_state {
+        int64_t since;
+        uint64_t last_pass;
+    };
+
+    struct player_state {
+        std::vector<timer_state> timers;
+        std::vector<bool> matched;
+        uint64_t last_pass{0};
+    };
+
+    const program &rules;
+    std::unordered_map<uint64_t, player_state> players;
+    uint64_t pass{0};
+
+public:
+    explicit evaluator(const program &rules);
+
+    /**
+     * Evaluate every rule against every player in the snapshot, appending the rules that newly
+     * matched to the output. Players missing from the snapshot have left the session, and their
+     * state is discarded.
+     */
+    void evaluate(std::span<const player_facts> players, int64_t now_ms, std::vector<match> &out);
+};
+
+}
+}
@@ -0,0 +1,37 @@
+#include "session_members.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+span<const gg::session_members::event> gg::session_members::tracker::update(
+    span<const member> current) {
+    events.clear();
+    members.resize(max(members.size(), current.size()));
+
+    // Comparing the slots is cheap, and only the slots that changed produce events
+    for (size_t i = 0; i < members.size(); i++) {
+        auto slot = static_cast<int>(i);
+        auto next = i < current.size() ? current[i] : member{};
+
+        auto &previous = members[i];
+        if (next == previous) {
+            continue;
+        }
+
+        if (previous == member{}) {
+            events.push_back({event_type::join, slot, next.player, next.steam_id, 0});
+        } else if (next == member{}) {
+            events.push_back({event_type::leave, slot, nullptr, 0, previous.steam_id});
+        } else {
+            events.push_back(
+                {event_type::replace, slot, next.player, next.steam_id, previous.steam_id});
+        }
+        previous = next;
+    }
+
+    members.resize(current.size());
+    return events;
+}
+
+void gg::session_members::tracker::reset() { members.clear(); }
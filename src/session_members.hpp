@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gg {
+namespace session_members {
+
+enum class event_type {
+    /**
+     * A player appeared in an empty slot
+     */
+    join,
+
+    /**
+     * A player left, and their slot is now empty
+     */
+    leave,
+
+    /**
+     * A slot now has a different PlayerIns. This happens after every loading screen, when the
+     * same players get new characters, as well as when one player takes another's slot.
+     */
+    replace,
+};
+
+/**
+ * The player in one slot of the session. The character is the game's PlayerIns, which is only
+ * compared here, so it's kept as an untyped pointer and this builds without the game's headers.
+ */
+struct member {
+    void *player{nullptr};
+    uint64_t steam_id{0};
+
+    bool operator==(const member &) const = default;
+};
+
+struct event {
+    event_type type;
+    int slot;
+
+    /**
+     * The PlayerIns now in the slot, or nullptr if they left
+     */
+    void *player;
+    uint64_t steam_id;
+
+    /**
+     * The player previously in the slot, for leave and replace events
+     */
+    uint64_t previous_steam_id;
+};
+
+/**
+ * Turns the players in each slot of the session into join, leave and replace events
+ */
+class tracker {
+private:
+    std::vector<member> members;
+    std::vector<event> events;
+
+public:
+    /**
+     * Compare the players in each slot against the last call, and return what changed. Empty
+     * slots are default members. The events are valid until the next call.
+     */
+    std::span<const event> update(std::span<const member> current);
+
+    /**
+     * Forget the current members, so the next update() reports everyone as joining
+     */
+    void reset();
+};
+
+}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace gg {
+
+/**
+ * Fixed-size lock-free queue with exactly one producer thread and one consumer thread. Pushing to
+ * a full queue fails instead of blocking, so the producer is never held up by a slow consumer.
+ */
+template <typename T, size_t capacity>
+class spsc_queue {
+private:
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    std::array<T, capacity> items;
+
+    // The indexes only ever increase, and are written by one side each. They're kept on separate
+    // cache lines so the two threads don't contend for them.
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+public:
+    /**
+     * Add an item to the back of the queue. Only call this from the producer thread.
+     *
+     * @returns false if the queue is full
+     */
+    bool push(const T &item) {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        items[t & (capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the item at the front of the queue. Only call this from the consumer thread.
+     */
+    std::optional<T> pop() {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        auto item = items[h & (capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return item;
+    }
+};
+
+}
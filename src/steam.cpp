@@ -0,0 +1,47 @@
+#include "steam.hpp"
+#include "fake_steam.hpp"
+
+#include <steam/isteamfriends.h>
+#include <steam/isteamutils.h>
+
+using namespace std;
+
+const char *gg::steam::get_persona_name(uint64_t steam_id) {
+    if (gg::fake_steam::is_fake(steam_id)) {
+        return gg::fake_steam::get_persona_name(steam_id);
+    }
+    return SteamFriends()->GetFriendPersonaName(CSteamID{steam_id});
+}
+
+bool gg::steam::get_small_avatar(uint64_t steam_id,
+                                 vector<unsigned char> &rgba,
+                                 unsigned int &width,
+                                 unsigned int &height) {
+    if (gg::fake_steam::is_fake(steam_id)) {
+        return gg::fake_steam::get_small_avatar(steam_id, rgba, width, height);
+    }
+
+    auto avatar = SteamFriends()->GetSmallFriendAvatar(CSteamID{steam_id});
+    if (!avatar) {
+        return false;
+    }
+
+    if (!SteamUtils()->GetImageSize(avatar, &width, &height)) {
+        return false;
+    }
+
+    rgba.resize(width * height * 4);
+    return SteamUtils()->GetImageRGBA(avatar, rgba.data(), static_cast<int>(rgba.size()));
+}
+
+SteamNetConnectionRealTimeStatus_t gg::steam::get_connection_status(uint64_t steam_id) {
+    if (gg::fake_steam::is_fake(steam_id)) {
+        return gg::fake_steam::get_connection_status(steam_id);
+    }
+
+    auto status = SteamNetConnectionRealTimeStatus_t{};
+    auto net_id = SteamNetworkingIdentity{};
+    net_id.SetSteamID(CSteamID{steam_id});
+    SteamNetworkingMessages()->GetSessionConnectionInfo(net_id, nullptr, &status);
+    return status;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <steam/isteamnetworkingmessages.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace gg {
+namespace steam {
+
+/**
+ * The Steam calls the mod makes about other players. Calls about players in the fake session are
+ * answered by fake_steam instead, so the rest of the mod doesn't need to know which is which.
+ */
+const char *get_persona_name(uint64_t steam_id);
+
+/**
+ * Copy a player's small Steam avatar into an RGBA buffer
+ *
+ * @returns false if they don't have an avatar, or it isn't loaded yet
+ */
+bool get_small_avatar(uint64_t steam_id,
+                      std::vector<unsigned char> &rgba,
+                      unsigned int &width,
+                      unsigned int &height);
+
+SteamNetConnectionRealTimeStatus_t get_connection_status(uint64_t steam_id);
+
+}
+}
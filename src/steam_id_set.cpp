@@ -0,0 +1,83 @@
+#include "steam_id_set.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+using namespace std;
+
+static constexpr size_t min_capacity = 16;
+
+/**
+ * Fibonacci hashing. SteamID64s only differ in their low 32 bits, so multiplying spreads those
+ * bits into the high bits used for the slot index.
+ */
+static inline size_t hash_slot(uint64_t id, unsigned int shift) {
+    return static_cast<size_t>((id * 0x9e3779b97f4a7c15ull) >> shift);
+}
+
+gg::steam_id_set::steam_id_set() { build_slots(); }
+
+gg::steam_id_set::steam_id_set(vector<uint64_t> ids)
+    : sorted_ids(move(ids)) {
+    // Lists merged from several sources are usually sorted already
+    if (!ranges::is_sorted(sorted_ids)) {
+        ranges::sort(sorted_ids);
+    }
+    auto [first, last] = ranges::unique(sorted_ids);
+    sorted_ids.erase(first, last);
+
+    // 0 marks an empty slot, and isn't a valid SteamID anyway
+    if (!sorted_ids.empty() && sorted_ids.front() == 0) {
+        sorted_ids.erase(sorted_ids.begin());
+    }
+
+    build_slots();
+}
+
+void gg::steam_id_set::build_slots() {
+    // Keep the table at most half full, so probe sequences stay short
+    auto capacity = max(bit_ceil(sorted_ids.size() * 2), min_capacity);
+    shift = 64 - countr_zero(capacity);
+    slots.assign(capacity, 0);
+
+    auto mask = capacity - 1;
+    for (auto id : sorted_ids) {
+        auto index = hash_slot(id, shift);
+        while (slots[index] != 0) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = id;
+    }
+}
+
+bool gg::steam_id_set::contains(uint64_t id) const {
+    if (id == 0) {
+        return false;
+    }
+
+    auto mask = slots.size() - 1;
+    for (auto index = hash_slot(id, shift);; index = (index + 1) & mask) {
+        auto slot = slots[index];
+        if (slot == id) return true;
+        if (slot == 0) return false;
+    }
+}
+
+gg::steam_id_set gg::steam_id_set::with(uint64_t id) const {
+    auto ids = sorted_ids;
+    ids.insert(ranges::upper_bound(ids, id), id);
+    return steam_id_set{move(ids)};
+}
+
+gg::steam_id_set gg::steam_id_set::without(uint64_t id) const {
+    return without(span{&id, 1});
+}
+
+gg::steam_id_set gg::steam_id_set::without(span<const uint64_t> removed_ids) const {
+    auto ids = vector<uint64_t>{};
+    ids.reserve(sorted_ids.size());
+    ranges::copy_if(sorted_ids, back_inserter(ids),
+                    [&](auto id) { return ranges::find(removed_ids, id) == removed_ids.end(); });
+    return steam_id_set{move(ids)};
+}
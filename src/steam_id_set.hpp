@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gg {
+
+/**
+ * Immutable set of 64-bit SteamIDs. IDs are kept sorted for iteration and rebuilding, and also
+ * stored in an open-addressed hash table so lookups are usually a single cache line and never
+ * lock or allocate.
+ */
+class steam_id_set {
+private:
+    std::vector<uint64_t> sorted_ids;
+    std::vector<uint64_t> slots;
+    unsigned int shift{64};
+
+    void build_slots();
+
+public:
+    steam_id_set();
+
+    /**
+     * Build a set from the given IDs, which don't need to be sorted or unique
+     */
+    explicit steam_id_set(std::vector<uint64_t> ids);
+
+    bool contains(uint64_t id) const;
+
+    size_t size() const { return sorted_ids.size(); }
+    bool empty() const { return sorted_ids.empty(); }
+    const std::vector<uint64_t> &ids() const { return sorted_ids; }
+
+    /**
+     * @returns the memory used by the sorted IDs and the hash table
+     */
+    size_t size_bytes() const {
+        return (sorted_ids.capacity() + slots.capacity()) * sizeof(uint64_t);
+    }
+
+    /**
+     * @returns a copy of this set with the given ID added
+     */
+    steam_id_set with(uint64_t id) const;
+
+    /**
+     * @returns a copy of this set with the given ID removed
+     */
+    steam_id_set without(uint64_t id) const;
+
+    /**
+     * @returns a copy of this set with all of the given IDs removed
+     */
+    steam_id_set without(std::span<const uint64_t> removed_ids) const;
+};
+
+}
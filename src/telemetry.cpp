@@ -0,0 +1,129 @@
+#include "telemetry.hpp"
+#include "config.hpp"
+#include "player_list.hpp"
+#include "trace.hpp"
+
+#include <array>
+#include <vector>
+
+using namespace std;
+
+/**
+ * History of one player slot, stored as one array per stat so a scan over a single stat (such as
+ * HP for the bar and trend) only touches that stat
+ */
+struct player_history {
+    uint64_t steam_id{0};
+
+    /**
+     * Number of samples taken since this player was first seen, up to history_size
+     */
+    size_t count{0};
+
+    array<int, gg::telemetry::history_size> hp;
+    array<int, gg::telemetry::history_size> max_hp;
+    array<int, gg::telemetry::history_size> fp;
+    array<int, gg::telemetry::history_size> max_fp;
+    array<int, gg::telemetry::history_size> level;
+};
+
+/**
+ * Every player is sampled at the same time, so the sample times and the position in the ring
+ * buffers are shared
+ */
+static array<chrono::steady_clock::time_point, gg::telemetry::history_size> sample_times;
+static size_t next_index = 0;
+static chrono::steady_clock::time_point last_sample_time;
+
+static vector<player_history> histories;
+
+void gg::telemetry::update() {
+    auto now = chrono::steady_clock::now();
+    auto interval = chrono::steady_clock::duration{chrono::seconds{1}} / gg::config::telemetry_rate;
+    if (now - last_sample_time < interval) {
+        return;
+    }
+    last_sample_time = now;
+
+    // Only frames that take a sample get a zone, so its cost isn't averaged away in traces
+    GG_TRACE_ZONE("telemetry::update");
+
+    auto &entries = gg::player_list_entries;
+    if (histories.size() < entries.size()) {
+        histories.resize(entries.size());
+    }
+
+    auto index = next_index;
+    next_index = (next_index + 1) % history_size;
+    sample_times[index] = now;
+
+    for (size_t slot = 0; slot < entries.size(); slot++) {
+        auto &entry = entries[slot];
+        auto &history = histories[slot];
+        if (!entry || !entry->player) {
+            history.steam_id = 0;
+            history.count = 0;
+            continue;
+        }
+
+        // Start over when a different player takes the slot
+        if (history.steam_id != entry->steam_id) {
+            history.steam_id = entry->steam_id;
+            history.count = 0;
+        }
+
+        auto game_data = entry->player->game_data;
+        history.hp[index] = game_data->hp;
+        history.max_hp[index] = game_data->max_hp;
+        history.fp[index] = game_data->fp;
+        history.max_fp[index] = game_data->max_fp;
+        history.level[index] = game_data->rune_level;
+        history.count = min(history.count + 1, history_size);
+    }
+}
+
+static gg::telemetry::sample get_sample(const player_history &history, size_t index) {
+    return {
+        .hp = history.hp[index],
+        .max_hp = history.max_hp[index],
+        .fp = history.fp[index],
+        .max_fp = history.max_fp[index],
+        .level = history.level[index],
+    };
+}
+
+optional<gg::telemetry::sample> gg::telemetry::latest(int slot) {
+    if (slot < 0 || slot >= histories.size() || histories[slot].count == 0) {
+        return nullopt;
+    }
+    return get_sample(histories[slot], (next_index + history_size - 1) % history_size);
+}
+
+optional<gg::telemetry::sample> gg::telemetry::ago(int slot, chrono::steady_clock::duration age) {
+    if (slot < 0 || slot >= histories.size() || histories[slot].count == 0) {
+        return nullopt;
+    }
+
+    // Walk back from the newest sample until one is old enough
+    auto &history = histories[slot];
+    auto target_time = sample_times[(next_index + history_size - 1) % history_size] - age;
+    auto index = (next_index + history_size - 1) % history_size;
+    for (size_t i = 1; i < history.count && sample_times[index] > target_time; i++) {
+        index = (index + history_size - 1) % history_size;
+    }
+    return get_sample(history, index);
+}
+
+gg::memory::usage gg::telemetry::memory_usage() {
+    return {
+        .count = histories.size(),
+        .bytes = histories.capacity() * sizeof(player_history) + sizeof(sample_times),
+    };
+}
+
+void gg::telemetry::trim() {
+    while (!histories.empty() && histories.back().steam_id == 0) {
+        histories.pop_back();
+    }
+    histories.shrink_to_fit();
+}
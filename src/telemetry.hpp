@@ -0,0 +1,55 @@
+#pragma once
+
+#include "memory.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace gg {
+namespace telemetry {
+
+/**
+ * How many samples are kept for each player. At the default rate of 10 per second, this is the
+ * last minute.
+ */
+static constexpr size_t history_size = 600;
+
+struct sample {
+    int hp;
+    int max_hp;
+    int fp;
+    int max_fp;
+    int level;
+};
+
+/**
+ * Read the stats of every player in the list in one pass, if it's time for another sample.
+ * Called by update_player_list() each frame.
+ */
+void update();
+
+/**
+ * @returns the most recent sample for the player in the given player list slot
+ */
+std::optional<sample> latest(int slot);
+
+/**
+ * @returns the sample for the player in the given slot from about the given time ago, or the
+ * oldest one if the history doesn't go back that far
+ */
+std::optional<sample> ago(int slot, std::chrono::steady_clock::duration age);
+
+/**
+ * @returns how many player slots have a history, and the memory used by them
+ */
+memory::usage memory_usage();
+
+/**
+ * Free the histories of empty slots at the end of the list, which are left behind after leaving a
+ * session with more players
+ */
+void trim();
+
+}
+}
@@ -0,0 +1,99 @@
+#include "timer_wheel.hpp"
+
+using namespace std;
+
+/**
+ * If the wheel falls this far behind (e.g. after the PC wakes from sleep), it's cheaper to
+ * re-insert every timer than to step through each tick
+ */
+static constexpr int64_t max_step_ticks = 4096;
+
+gg::timer_wheel::timer_wheel(int64_t start_tick)
+    : current_tick(start_tick) {}
+
+void gg::timer_wheel::insert(const timer &t) {
+    auto delta = t.expires - current_tick;
+
+    // Timers that are already due fire on the next tick
+    if (delta <= 0) {
+        levels[0][(current_tick + 1) & (slot_count - 1)].push_back(t);
+        return;
+    }
+
+    for (unsigned int level = 0; level < level_count; level++) {
+        auto shift = slot_bits * level;
+        if (delta < int64_t{1} << (shift + slot_bits)) {
+            levels[level][(t.expires >> shift) & (slot_count - 1)].push_back(t);
+            return;
+        }
+    }
+
+    // Too far in the future for the wheel. Put it in the last slot of the top level, and it'll be
+    // placed again when that slot is cascaded.
+    auto shift = slot_bits * (level_count - 1);
+    auto last_tick = current_tick + (int64_t{1} << (shift + slot_bits)) - 1;
+    levels[level_count - 1][(last_tick >> shift) & (slot_count - 1)].push_back(t);
+}
+
+void gg::timer_wheel::add(uint64_t id, int64_t expires) {
+    insert({id, expires});
+    timer_count++;
+}
+
+void gg::timer_wheel::advance(int64_t tick,
+                              const function<void(uint64_t, int64_t)> &on_expired) {
+    if (tick <= current_tick) {
+        return;
+    }
+
+    if (tick - current_tick > max_step_ticks) {
+        auto timers = vector<timer>{};
+        timers.reserve(timer_count);
+        for (auto &level : levels) {
+            for (auto &slot : level) {
+                timers.insert(timers.end(), slot.begin(), slot.end());
+                slot.clear();
+            }
+        }
+
+        current_tick = tick;
+        for (auto &t : timers) {
+            if (t.expires <= tick) {
+                timer_count--;
+                on_expired(t.id, t.expires);
+            } else {
+                insert(t);
+            }
+        }
+        return;
+    }
+
+    auto slot_timers = vector<timer>{};
+    while (current_tick < tick) {
+        current_tick++;
+
+        // When a lower level wraps around, move timers from the next slot of the level above
+        // down into finer slots. Start at the top so timers can cascade more than one level.
+        for (auto level = level_count - 1; level > 0; level--) {
+            auto shift = slot_bits * level;
+            if ((current_tick & ((int64_t{1} << shift) - 1)) == 0) {
+                slot_timers.swap(levels[level][(current_tick >> shift) & (slot_count - 1)]);
+                for (auto &t : slot_timers) {
+                    insert(t);
+                }
+                slot_timers.clear();
+            }
+        }
+
+        slot_timers.swap(levels[0][current_tick & (slot_count - 1)]);
+        for (auto &t : slot_timers) {
+            if (t.expires <= current_tick) {
+                timer_count--;
+                on_expired(t.id, t.expires);
+            } else {
+                insert(t);
+            }
+        }
+        slot_timers.clear();
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace gg {
+
+/**
+ * Hierarchical timer wheel of 64 bit IDs that expire at a given tick. Inserting and advancing by
+ * one tick are O(1), and timers far in the future are cascaded into finer levels as their time
+ * approaches, so the wheel can be ticked every frame regardless of how many timers it holds.
+ *
+ * Timers can't be cancelled. Callers that need that should check whether a timer is still wanted
+ * when it fires.
+ */
+class timer_wheel {
+private:
+    static constexpr unsigned int slot_bits = 6;
+    static constexpr unsigned int slot_count = 1 << slot_bits;
+    static constexpr unsigned int level_count = 4;
+
+    struct timer {
+        uint64_t id;
+        int64_t expires;
+    };
+
+    std::array<std::array<std::vector<timer>, slot_count>, level_count> levels;
+    int64_t current_tick;
+    size_t timer_count{0};
+
+    void insert(const timer &t);
+
+public:
+    explicit timer_wheel(int64_t start_tick);
+
+    /**
+     * Add a timer that fires once the wheel is advanced to the given tick
+     */
+    void add(uint64_t id, int64_t expires);
+
+    /**
+     * Advance the wheel to the given tick, calling on_expired with the ID and expiration tick of
+     * every timer that fires along the way
+     */
+    void advance(int64_t tick, const std::function<void(uint64_t, int64_t)> &on_expired);
+
+    size_t size() const { return timer_count; }
+};
+
+}
@@ -0,0 +1,219 @@
+#include "trace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+atomic<bool> gg::trace::detail::recording{false};
+
+struct trace_event {
+    const char *name;
+    int64_t start_ns;
+    int64_t end_ns;
+};
+
+/**
+ * Enough for a few hundred zones a frame for several seconds
+ */
+static constexpr size_t buffer_capacity = 1 << 15;
+
+/**
+ * Zones recorded by one thread during the capture numbered `capture`. Only the owning thread
+ * writes to a buffer, and it resets the buffer the first time it records in a new capture. The
+ * writer reads the first `size` events after the capture stops, so a zone that was being recorded
+ * just as it stopped is never read half written.
+ */
+struct thread_buffer {
+    uint32_t tid;
+    atomic<const char *> thread_name{nullptr};
+    atomic<uint32_t> capture{0};
+    atomic<size_t> size{0};
+    atomic<size_t> dropped{0};
+    unique_ptr<trace_event[]> events;
+};
+
+static mutex buffers_mutex;
+static vector<unique_ptr<thread_buffer>> buffers;
+static thread_local thread_buffer *local_buffer{nullptr};
+
+static atomic<uint32_t> current_capture{0};
+static atomic<bool> writing{false};
+static int64_t capture_start_ns;
+static chrono::steady_clock::time_point capture_end;
+static fs::path capture_path;
+
+/**
+ * @returns the calling thread's buffer, which is created the first time each thread records
+ */
+static thread_buffer &get_buffer() {
+    if (!local_buffer) {
+        auto lock = lock_guard{buffers_mutex};
+        auto &buffer = buffers.emplace_back(make_unique<thread_buffer>());
+        buffer->tid = static_cast<uint32_t>(buffers.size());
+        local_buffer = buffer.get();
+    }
+    return *local_buffer;
+}
+
+static void write_string(ostream &stream, string_view s) {
+    stream << '"';
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            stream << '\\';
+        }
+        stream << c;
+    }
+    stream << '"';
+}
+
+/**
+ * Write every zone recorded during a capture as a Chrome trace "complete" event, with timestamps
+ * in microseconds from the start of the capture
+ *
+ * https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+ */
+static void write_capture(uint32_t capture, int64_t start_ns, fs::path path) {
+    auto snapshot = vector<thread_buffer *>{};
+    {
+        auto lock = lock_guard{buffers_mutex};
+        for (auto &buffer : buffers) {
+            snapshot.push_back(buffer.get());
+        }
+    }
+
+    auto error = error_code{};
+    fs::create_directories(path.parent_path(), error);
+
+    auto file = ofstream{path};
+    if (!file) {
+        SPDLOG_ERROR("Failed to write {}", path.string());
+        writing.store(false, memory_order_release);
+        return;
+    }
+
+    file << fixed << setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto first = true;
+    auto begin_event = [&](uint32_t tid, string_view name, string_view phase) {
+        file << (first ? "\n" : ",\n") << "{\"pid\":1,\"tid\":" << tid << ",\"ph\":\"" << phase
+             << "\",\"name\":";
+        write_string(file, name);
+        first = false;
+    };
+
+    size_t event_count = 0;
+    size_t dropped_count = 0;
+    for (auto buffer : snapshot) {
+        if (buffer->capture.load(memory_order_acquire) != capture) {
+            continue;
+        }
+
+        auto thread_name = buffer->thread_name.load(memory_order_relaxed);
+        begin_event(buffer->tid, "thread_name", "M");
+        file << ",\"args\":{\"name\":";
+        write_string(file, thread_name ? thread_name : "thread " + to_string(buffer->tid));
+        file << "}}";
+
+        auto size = buffer->size.load(memory_order_acquire);
+        for (size_t i = 0; i < size; i++) {
+            auto &event = buffer->events[i];
+
+            // Started before this capture, and finished after the next one began
+            if (event.start_ns < start_ns) {
+                continue;
+            }
+
+            begin_event(buffer->tid, event.name, "X");
+            file << ",\"ts\":" << (event.start_ns - start_ns) / 1000.
+                 << ",\"dur\":" << (event.end_ns - event.start_ns) / 1000. << "}";
+            event_count++;
+        }
+        dropped_count += buffer->dropped.load(memory_order_relaxed);
+    }
+
+    file << "\n]}\n";
+    file.close();
+
+    if (dropped_count > 0) {
+        SPDLOG_WARN("Dropped {} zones because a thread's trace buffer was full", dropped_count);
+    }
+    SPDLOG_INFO("Wrote {} zones to {}", event_count, path.string());
+
+    writing.store(false, memory_order_release);
+}
+
+void gg::trace::detail::record(const char *name, int64_t start_ns, int64_t end_ns) {
+    if (!recording.load(memory_order_acquire)) {
+        return;
+    }
+
+    auto &buffer = get_buffer();
+    auto capture = current_capture.load(memory_order_relaxed);
+    if (buffer.capture.load(memory_order_relaxed) != capture) {
+        if (!buffer.events) {
+            buffer.events = make_unique<trace_event[]>(buffer_capacity);
+        }
+        buffer.size.store(0, memory_order_relaxed);
+        buffer.dropped.store(0, memory_order_relaxed);
+        buffer.capture.store(capture, memory_order_release);
+    }
+
+    auto size = buffer.size.load(memory_order_relaxed);
+    if (size == buffer_capacity) {
+        buffer.dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[size] = {name, start_ns, end_ns};
+    buffer.size.store(size + 1, memory_order_release);
+}
+
+void gg::trace::set_thread_name(const char *name) {
+    get_buffer().thread_name.store(name, memory_order_relaxed);
+}
+
+bool gg::trace::start(chrono::steady_clock::duration duration, const fs::path &folder) {
+    if (detail::recording.load(memory_order_relaxed) || writing.load(memory_order_acquire)) {
+        SPDLOG_WARN("Can't start a trace while the last one is still being captured");
+        return false;
+    }
+
+    auto time = chrono::system_clock::to_time_t(chrono::system_clock::now());
+    auto filename = ostringstream{};
+    filename << "trace-" << put_time(localtime(&time), "%Y%m%d-%H%M%S") << ".json";
+
+    capture_path = folder / filename.str();
+    capture_end = chrono::steady_clock::now() + duration;
+    capture_start_ns = detail::now_ns();
+    current_capture.fetch_add(1, memory_order_relaxed);
+    detail::recording.store(true, memory_order_release);
+
+    SPDLOG_INFO("Capturing a trace for {} seconds",
+                chrono::duration_cast<chrono::seconds>(duration).count());
+    return true;
+}
+
+void gg::trace::update() {
+    if (!detail::recording.load(memory_order_relaxed) ||
+        chrono::steady_clock::now() < capture_end) {
+        return;
+    }
+
+    detail::recording.store(false, memory_order_release);
+    writing.store(true, memory_order_release);
+    thread(write_capture, current_capture.load(memory_order_relaxed), capture_start_ns,
+           capture_path)
+        .detach();
+}
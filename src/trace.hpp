@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace gg {
+namespace trace {
+
+namespace detail {
+
+extern std::atomic<bool> recording;
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void record(const char *name, int64_t start_ns, int64_t end_ns);
+
+}
+
+/**
+ * Times the enclosing scope while a capture is running. When nothing is being captured this is a
+ * single relaxed load, so zones can be left in hot paths. The name must be a string literal, since
+ * only the pointer is stored.
+ */
+class zone {
+private:
+    const char *name;
+    int64_t start_ns{-1};
+
+public:
+    explicit zone(const char *name) : name(name) {
+        if (detail::recording.load(std::memory_order_relaxed)) {
+            start_ns = detail::now_ns();
+        }
+    }
+
+    ~zone() {
+        if (start_ns >= 0) {
+            detail::record(name, start_ns, detail::now_ns());
+        }
+    }
+
+    zone(const zone &) = delete;
+    zone &operator=(const zone &) = delete;
+};
+
+/**
+ * Name the calling thread in captured traces. The name must be a string literal.
+ */
+void set_thread_name(const char *name);
+
+/**
+ * Start recording zones on every thread for the given duration, then write them to a new file in
+ * the given folder in the Chrome trace event format, which can be opened in Perfetto or
+ * chrome://tracing. Each thread records into its own fixed-size buffer without locking, and zones
+ * past the end of the buffer are dropped.
+ *
+ * @returns false if a capture is already running or still being written
+ */
+bool start(std::chrono::steady_clock::duration duration, const std::filesystem::path &folder);
+
+/**
+ * Stop the capture once its duration is up, and write it on a background thread. Called by the
+ * render task each frame, so a capture started before the first frame runs until then.
+ */
+void update();
+
+}
+}
+
+/**
+ * Time the rest of the enclosing scope as a zone with the given name. Building without
+ * ERGG_TRACING removes every zone, so they cost nothing at all.
+ */
+#ifdef ERGG_TRACING
+#define GG_TRACE_CONCAT_IMPL(a, b) a##b
+#define GG_TRACE_CONCAT(a, b) GG_TRACE_CONCAT_IMPL(a, b)
+#define GG_TRACE_ZONE(name) const gg::trace::zone GG_TRACE_CONCAT(trace_zone_, __LINE__){name}
+#define GG_TRACE_THREAD(name) gg::trace::set_thread_name(name)
+#else
+#define GG_TRACE_ZONE(name) static_cast<void>(0)
+#define GG_TRACE_THREAD(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,21 @@
+#include "utf8.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+void gg::utf8::copy_truncated(span<char> destination, string_view text) {
+    if (destination.empty()) {
+        return;
+    }
+
+    auto length = min(text.size(), destination.size() - 1);
+
+    // Continuation bytes start with 10, so back up until the cut is before a leading byte
+    while (length > 0 && length < text.size() && (text[length] & 0xc0) == 0x80) {
+        length--;
+    }
+
+    ranges::fill(ranges::copy(text.substr(0, length), destination.begin()).out, destination.end(),
+                 '\0');
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+namespace gg {
+namespace utf8 {
+
+/**
+ * Copy a UTF-8 string into a fixed-size buffer, truncated so it fits with a null terminator and
+ * doesn't end partway through a multi-byte character. The rest of the buffer is zeroed.
+ */
+void copy_truncated(std::span<char> destination, std::string_view text);
+
+}
+}
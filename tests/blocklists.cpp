@@ -0,0 +1,123 @@
+#include "blocklists.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * A folder for the files written by one test, deleted when the test ends
+ */
+class blocklists_test : public testing::Test {
+protected:
+    fs::path folder;
+
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        folder = fs::temp_directory_path() / "ergg_tests" / test->name();
+        fs::remove_all(folder);
+        fs::create_directories(folder);
+    }
+
+    void TearDown() override { fs::remove_all(folder); }
+
+    fs::path write_file(const string &name, string_view contents) {
+        auto path = folder / name;
+        auto stream = ofstream{path, ios::binary};
+        stream.write(contents.data(), contents.size());
+        return path;
+    }
+};
+
+TEST(blocklists, parse_text) {
+    auto ids = gg::blocklists::parse_text("76561197960287930\n"
+                                          "  76561198000000000   # a comment\r\n"
+                                          "\n"
+                                          "# 76561198000000001\n"
+                                          "not an ID\n"
+                                          "123\n"
+                                          "76561198000000002");
+    EXPECT_EQ(ids, (vector<uint64_t>{76561197960287930ull, 76561198000000000ull, 123,
+                                     76561198000000002ull}));
+}
+
+TEST(blocklists, parse_text_skips_bom_and_overflow) {
+    auto ids = gg::blocklists::parse_text("\xef\xbb\xbf"
+                                          "76561197960287930\n"
+                                          "123456789012345678901234\n"
+                                          "0\n");
+    EXPECT_EQ(ids, vector<uint64_t>{76561197960287930ull});
+}
+
+TEST(blocklists, parse_text_empty) {
+    EXPECT_TRUE(gg::blocklists::parse_text("").empty());
+    EXPECT_TRUE(gg::blocklists::parse_text("\n\n# nothing here\n").empty());
+}
+
+TEST(blocklists, merge) {
+    auto a = vector<uint64_t>{1, 4, 7};
+    auto b = vector<uint64_t>{2, 4, 8};
+    auto c = vector<uint64_t>{};
+    auto sources = vector<span<const uint64_t>>{a, b, c};
+    EXPECT_EQ(gg::blocklists::merge(sources), (vector<uint64_t>{1, 2, 4, 7, 8}));
+}
+
+TEST_F(blocklists_test, binary_round_trip) {
+    auto ids = vector<uint64_t>{76561197960287930ull, 76561198000000000ull};
+    auto path = folder / "list.bin";
+    ASSERT_TRUE(gg::blocklists::write_binary(path, ids));
+
+    auto file = gg::platform::mapped_file{path};
+    auto read = gg::blocklists::read_binary(file);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(ranges::equal(*read, ids));
+}
+
+TEST_F(blocklists_test, binary_empty_list_is_valid) {
+    auto path = folder / "empty.bin";
+    ASSERT_TRUE(gg::blocklists::write_binary(path, {}));
+
+    auto file = gg::platform::mapped_file{path};
+    auto read = gg::blocklists::read_binary(file);
+    ASSERT_TRUE(read.has_value());
+    EXPECT_TRUE(read->empty());
+}
+
+TEST_F(blocklists_test, binary_rejects_invalid_files) {
+    auto check_invalid = [&](const string &name, string_view contents) {
+        auto file = gg::platform::mapped_file{write_file(name, contents)};
+        EXPECT_FALSE(gg::blocklists::read_binary(file).has_value()) << name;
+    };
+
+    check_invalid("empty.bin", "");
+    check_invalid("text.bin", "76561197960287930\n76561198000000000\n");
+
+    // A valid header that claims more IDs than the file holds
+    auto ids = vector<uint64_t>{1, 2};
+    auto path = folder / "valid.bin";
+    ASSERT_TRUE(gg::blocklists::write_binary(path, ids));
+    auto contents = string{};
+    {
+        auto stream = ifstream{path, ios::binary};
+        contents.assign(istreambuf_iterator<char>{stream}, {});
+    }
+    check_invalid("truncated.bin", string_view{contents}.substr(0, contents.size() - 1));
+}
+
+TEST_F(blocklists_test, binary_rejects_unsorted_or_duplicate_ids) {
+    auto check_invalid = [&](const string &name, vector<uint64_t> ids) {
+        auto path = folder / name;
+        ASSERT_TRUE(gg::blocklists::write_binary(path, ids));
+        auto file = gg::platform::mapped_file{path};
+        EXPECT_FALSE(gg::blocklists::read_binary(file).has_value()) << name;
+    };
+
+    check_invalid("unsorted.bin", {3, 1, 2});
+    check_invalid("duplicates.bin", {1, 2, 2, 3});
+}
@@ -0,0 +1,45 @@
+#include "bloom_filter.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+static vector<uint64_t> random_steam_ids(size_t count, unsigned int seed) {
+    auto rng = mt19937_64{seed};
+    auto ids = vector<uint64_t>(count);
+    for (auto &id : ids) {
+        id = 76561197960265728ull + (rng() & 0xffffffff);
+    }
+    return ids;
+}
+
+TEST(bloom_filter, no_false_negatives) {
+    auto ids = random_steam_ids(10'000, 1);
+    auto filter = gg::bloom_filter{ids, .01};
+    for (auto id : ids) {
+        ASSERT_TRUE(filter.may_contain(id));
+    }
+}
+
+TEST(bloom_filter, false_positive_rate) {
+    auto filter = gg::bloom_filter{random_steam_ids(10'000, 1), .01};
+
+    auto others = random_steam_ids(100'000, 2);
+    auto false_positives = ranges::count_if(others, [&](auto id) {
+        return filter.may_contain(id);
+    });
+
+    // Blocked filters are a little worse than the ideal rate, but should stay close to it
+    EXPECT_LT(false_positives, 3'000);
+}
+
+TEST(bloom_filter, size_grows_with_ids) {
+    auto small = gg::bloom_filter{random_steam_ids(1'000, 1), .01};
+    auto large = gg::bloom_filter{random_steam_ids(100'000, 1), .01};
+    EXPECT_GT(small.size_bytes(), 0);
+    EXPECT_GT(large.size_bytes(), small.size_bytes() * 50);
+}
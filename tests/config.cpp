@@ -0,0 +1,220 @@
+#include "config.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/**
+ * Loads ergg.ini from a folder of its own for each test. The config is global, so every test
+ * loads it again rather than relying on what an earlier test left behind.
+ */
+class config_test : public testing::Test {
+protected:
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        gg::config::mod_folder = fs::temp_directory_path() / "ergg_tests" / test->name();
+        fs::remove_all(gg::config::mod_folder);
+        fs::create_directories(gg::config::mod_folder);
+    }
+
+    void TearDown() override { fs::remove_all(gg::config::mod_folder); }
+
+    void load(const string &ini) {
+        {
+            auto file = ofstream{gg::config::mod_folder / "ergg.ini"};
+            file << ini;
+        }
+        gg::config::load();
+    }
+};
+
+TEST_F(config_test, missing_file_writes_defaults) {
+    gg::config::load();
+
+    EXPECT_TRUE(fs::exists(gg::config::mod_folder / "ergg.ini"));
+    EXPECT_TRUE(gg::config::show_ping);
+    EXPECT_FALSE(gg::config::show_yourself);
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_DOUBLE_EQ(gg::config::bloom_filter_false_positive_rate, .01);
+    EXPECT_EQ(gg::config::toggle_logs_key, ImGuiKey_GraveAccent);
+    EXPECT_EQ(gg::config::player_list_columns, "avatar, name, level, ping");
+    EXPECT_TRUE(gg::config::auto_block_rules->empty());
+
+    // The written file loads back to the same values
+    gg::config::high_ping = 0;
+    gg::config::player_list_columns.clear();
+    gg::config::load();
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_EQ(gg::config::player_list_columns, "avatar, name, level, ping");
+}
+
+TEST_F(config_test, parses_values) {
+    load("[overlay]\n"
+         "show_ping = false\n"
+         "high_ping = 250\n"
+         "columns = name, ping\n"
+         "[blocklist]\n"
+         "bloom_filter_false_positive_rate = 0.05\n"
+         "[actions]\n"
+         "toggle_logs = f9\n"
+         "[rules]\n"
+         "laggy = ping > 300 for 20s => warn\n"
+         "twink = level < 30 => block\n");
+
+    EXPECT_FALSE(gg::config::show_ping);
+    EXPECT_EQ(gg::config::high_ping, 250);
+    EXPECT_EQ(gg::config::player_list_columns, "name, ping");
+    EXPECT_DOUBLE_EQ(gg::config::bloom_filter_false_positive_rate, .05);
+    EXPECT_EQ(gg::config::toggle_logs_key, ImGuiKey_F9);
+    EXPECT_EQ(gg::config::auto_block_rules->rule_names.size(), 2);
+}
+
+TEST_F(config_test, booleans_and_keys_ignore_case) {
+    load("[overlay]\n"
+         "show_ping = FALSE\n"
+         "show_yourself = True\n"
+         "[actions]\n"
+         "toggle_logs = F9\n"
+         "toggle_settings = GraveAccent\n");
+
+    EXPECT_FALSE(gg::config::show_ping);
+    EXPECT_TRUE(gg::config::show_yourself);
+    EXPECT_EQ(gg::config::toggle_logs_key, ImGuiKey_F9);
+    EXPECT_EQ(gg::config::toggle_settings_key, ImGuiKey_GraveAccent);
+}
+
+TEST_F(config_test, strings_keep_their_case) {
+    load("[overlay]\n"
+         "columns = Name, Ping\n"
+         "[fake_steam]\n"
+         "ping_trace = 40, 45\n");
+
+    EXPECT_EQ(gg::config::player_list_columns, "Name, Ping");
+    EXPECT_EQ(gg::config::fake_steam_ping_trace, "40, 45");
+}
+
+TEST(config, get_range) {
+    EXPECT_EQ(gg::config::get_range(gg::config::high_ping), (pair{0u, 10000u}));
+    EXPECT_EQ(gg::config::get_range(gg::config::telemetry_rate), (pair{1u, 60u}));
+
+    auto not_a_setting = 0u;
+    EXPECT_EQ(gg::config::get_range(not_a_setting), (pair{0u, 0u}));
+}
+
+TEST_F(config_test, invalid_values_keep_defaults) {
+    load("[overlay]\n"
+         "show_ping = maybe\n"
+         "high_ping = -5\n"
+         "telemetry_rate = 10 per second\n"
+         "[blocklist]\n"
+         "bloom_filter_false_positive_rate = nan\n"
+         "[actions]\n"
+         "toggle_logs = not a key\n"
+         "[misc]\n"
+         "trace_seconds =\n");
+
+    EXPECT_TRUE(gg::config::show_ping);
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_EQ(gg::config::telemetry_rate, 10);
+    EXPECT_DOUBLE_EQ(gg::config::bloom_filter_false_positive_rate, .01);
+    EXPECT_EQ(gg::config::toggle_logs_key, ImGuiKey_GraveAccent);
+    EXPECT_EQ(gg::config::trace_seconds, 5);
+}
+
+TEST_F(config_test, out_of_range_values_keep_defaults) {
+    load("[overlay]\n"
+         "high_ping = 10001\n"
+         "telemetry_rate = 0\n"
+         "[blocklist]\n"
+         "bloom_filter_false_positive_rate = 0.9\n"
+         "[fake_steam]\n"
+         "players = 4294967296\n");
+
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_EQ(gg::config::telemetry_rate, 10);
+    EXPECT_DOUBLE_EQ(gg::config::bloom_filter_false_positive_rate, .01);
+    EXPECT_EQ(gg::config::fake_steam_players, 3);
+
+    load("[overlay]\n"
+         "high_ping = 10000\n"
+         "telemetry_rate = 1\n");
+
+    EXPECT_EQ(gg::config::high_ping, 10000);
+    EXPECT_EQ(gg::config::telemetry_rate, 1);
+}
+
+TEST_F(config_test, missing_sections_keep_defaults) {
+    load("[misc]\n"
+         "debug = true\n");
+
+    EXPECT_TRUE(gg::config::debug);
+    EXPECT_TRUE(gg::config::show_ping);
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_EQ(gg::config::toggle_player_list_key, ImGuiKey_F2);
+    EXPECT_TRUE(gg::config::auto_block_rules->empty());
+}
+
+TEST_F(config_test, ignores_garbage) {
+    load("\xef\xbb\xbf"
+         "this line means nothing\n"
+         "[overlay\n"
+         "=\n"
+         "= value without a name\n"
+         "[overlay]\n"
+         "high_ping = 200\n"
+         "\x01\x02\x7f\xff garbage bytes \xfe\n"
+         "unknown_option = 1\n"
+         "[unknown section]\n"
+         "show_ping = false\n"
+         "[rules]\n"
+         "valid = ping > 300 => warn\n"
+         "broken = ping >\n"
+         "also broken = \"unterminated => block\n");
+
+    EXPECT_EQ(gg::config::high_ping, 200);
+    EXPECT_TRUE(gg::config::show_ping);
+    EXPECT_EQ(gg::config::auto_block_rules->rule_names, vector<string>{"valid"});
+}
+
+TEST_F(config_test, empty_file_keeps_defaults) {
+    load("");
+
+    EXPECT_TRUE(gg::config::show_ping);
+    EXPECT_EQ(gg::config::high_ping, 100);
+    EXPECT_EQ(gg::config::player_list_columns, "avatar, name, level, ping");
+}
+
+TEST_F(config_test, very_large_file) {
+    auto ini = string{};
+    ini += "[overlay]\n";
+    for (int i = 0; i < 100'000; i++) {
+        ini += "junk_" + to_string(i) + " = " + string(i % 200, 'x') + "\n";
+        if (i % 1000 == 0) {
+            ini += "not even a key value pair " + to_string(i) + "\n";
+        }
+    }
+    ini += "high_ping = 300\n";
+    ini += "columns = " + string(100'000, 'c') + "\n";
+
+    ini += "[rules]\n";
+    for (int i = 0; i < 5000; i++) {
+        auto name = "rule_" + to_string(i);
+        if (i % 2 == 0) {
+            ini += name + " = ping > " + to_string(i) + " for 5s and level < 30 => warn\n";
+        } else {
+            ini += name + " = ping is very high => explode\n";
+        }
+    }
+    load(ini);
+
+    EXPECT_EQ(gg::config::high_ping, 300);
+    EXPECT_EQ(gg::config::player_list_columns.size(), 100'000);
+    EXPECT_EQ(gg::config::auto_block_rules->rule_names.size(), 2500);
+    EXPECT_EQ(gg::config::auto_block_rules->timer_count, 2500);
+}
@@ -0,0 +1,82 @@
+#include "encounter_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+using record = gg::encounter_file::record;
+
+class encounter_file_test : public testing::Test {
+protected:
+    fs::path path;
+
+    void SetUp() override {
+        auto test = testing::UnitTest::GetInstance()->current_test_info();
+        auto folder = fs::temp_directory_path() / "ergg_tests" / test->name();
+        fs::remove_all(folder);
+        fs::create_directories(folder);
+        path = folder / "encounters.dat";
+    }
+
+    void TearDown() override { fs::remove_all(path.parent_path()); }
+
+    vector<uint64_t> scan_ids() {
+        auto file = gg::encounter_file{};
+        EXPECT_TRUE(file.open(path));
+
+        auto ids = vector<uint64_t>{};
+        file.scan(0, [&](const record &r, uint64_t offset) {
+            EXPECT_EQ(offset, ids.size() * sizeof(record));
+            ids.push_back(r.steam_id);
+        });
+        return ids;
+    }
+};
+
+TEST_F(encounter_file_test, append_and_read) {
+    auto file = gg::encounter_file{};
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.size(), 0);
+
+    EXPECT_EQ(file.append({.steam_id = 1, .times_met = 1}), 0);
+    EXPECT_EQ(file.append({.steam_id = 2, .times_met = 5}), sizeof(record));
+    EXPECT_EQ(file.size(), 2 * sizeof(record));
+
+    auto r = file.read(sizeof(record));
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->steam_id, 2);
+    EXPECT_EQ(r->times_met, 5);
+    EXPECT_FALSE(file.read(2 * sizeof(record)).has_value());
+}
+
+TEST_F(encounter_file_test, rebuild_after_torn_record) {
+    {
+        auto file = gg::encounter_file{};
+        ASSERT_TRUE(file.open(path));
+        for (uint64_t id = 1; id <= 3; id++) {
+            file.append({.steam_id = id});
+        }
+    }
+
+    // The game closed partway through writing a fourth record
+    {
+        auto torn = record{.steam_id = 4};
+        auto stream = ofstream{path, ios::binary | ios::app};
+        stream.write(reinterpret_cast<const char *>(&torn), sizeof(torn) / 2);
+    }
+
+    {
+        auto file = gg::encounter_file{};
+        ASSERT_TRUE(file.open(path));
+        EXPECT_EQ(file.size(), 3 * sizeof(record));
+        EXPECT_EQ(file.append({.steam_id = 5}), 3 * sizeof(record));
+    }
+
+    EXPECT_EQ(fs::file_size(path), 4 * sizeof(record));
+    EXPECT_EQ(scan_ids(), (vector<uint64_t>{1, 2, 3, 5}));
+}
@@ -0,0 +1,15 @@
+#include <gtest/gtest.h>
+#include <spdlog/spdlog.h>
+
+#include <memory>
+
+using namespace std;
+
+int main(int argc, char **argv) {
+    // The default logger is disabled in the build. Tests feed in plenty of invalid input, so
+    // give them one that discards the warnings instead of printing them.
+    spdlog::set_default_logger(make_shared<spdlog::logger>("ergg_tests"));
+
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
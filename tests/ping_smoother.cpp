@@ -0,0 +1,58 @@
+#include "ping_smoother.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace std;
+
+TEST(ping_smoother, first_ping_is_shown_immediately) {
+    auto smoother = gg::ping_smoother{};
+    EXPECT_EQ(smoother.value, -1);
+    smoother.update(80);
+    EXPECT_EQ(smoother.value, 80);
+}
+
+TEST(ping_smoother, ignores_small_fluctuations) {
+    auto smoother = gg::ping_smoother{};
+    smoother.update(80);
+    for (int i = 0; i < 100; i++) {
+        smoother.update(i % 2 == 0 ? 85 : 75);
+    }
+    EXPECT_EQ(smoother.value, 80);
+}
+
+TEST(ping_smoother, follows_consistent_changes) {
+    auto smoother = gg::ping_smoother{};
+    smoother.update(80);
+    smoother.update(120);
+    smoother.update(120);
+    EXPECT_EQ(smoother.value, 80);
+    smoother.update(120);
+    EXPECT_EQ(smoother.value, 120);
+}
+
+TEST(ping_smoother, samples_jitter_once_a_second) {
+    auto smoother = gg::ping_smoother{};
+    auto now = chrono::steady_clock::time_point{} + chrono::hours{1};
+
+    EXPECT_TRUE(smoother.sample(100, now));
+    EXPECT_FLOAT_EQ(smoother.jitter, 0.f);
+
+    EXPECT_FALSE(smoother.sample(200, now + chrono::milliseconds{500}));
+    EXPECT_FLOAT_EQ(smoother.jitter, 0.f);
+
+    EXPECT_TRUE(smoother.sample(116, now + chrono::seconds{1}));
+    EXPECT_FLOAT_EQ(smoother.jitter, 1.f);
+    EXPECT_EQ(smoother.last_sample, 116);
+}
+
+TEST(ping_smoother, unknown_pings_dont_affect_jitter) {
+    auto smoother = gg::ping_smoother{};
+    auto now = chrono::steady_clock::time_point{} + chrono::hours{1};
+
+    EXPECT_TRUE(smoother.sample(100, now));
+    EXPECT_TRUE(smoother.sample(-1, now + chrono::seconds{1}));
+    EXPECT_TRUE(smoother.sample(300, now + chrono::seconds{2}));
+    EXPECT_FLOAT_EQ(smoother.jitter, 0.f);
+}
@@ -0,0 +1,147 @@
+#include "rules.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+using gg::rules::action;
+using gg::rules::match;
+using gg::rules::player_facts;
+
+static gg::rules::program compile_all(const vector<pair<string, string>> &rules) {
+    auto program = gg::rules::program{};
+    for (auto &[name, text] : rules) {
+        EXPECT_TRUE(gg::rules::compile(name, text, program)) << text;
+    }
+    return program;
+}
+
+static player_facts player(uint64_t steam_id, int ping, int rune_level,
+                           string in_game_name = "tarnished") {
+    return {.steam_id = steam_id,
+            .in_game_name = in_game_name,
+            .steam_name = "steam name",
+            .ping = ping,
+            .rune_level = rune_level};
+}
+
+TEST(rules, compile_valid_rules) {
+    auto program = compile_all({
+        {"laggy", "ping > 300 for 20s => warn"},
+        {"twink", "level < 30 and ping > 200 => block"},
+        {"range", "level outside 1-713 => block"},
+        {"name", "name matches \"*let me solo*\" => warn"},
+    });
+
+    EXPECT_EQ(program.rule_names, (vector<string>{"laggy", "twink", "range", "name"}));
+    EXPECT_EQ(program.patterns, vector<string>{"*let me solo*"});
+    EXPECT_EQ(program.timer_count, 1);
+
+    // Each rule's conditions, then its fire instruction
+    ASSERT_EQ(program.instructions.size(), 9);
+    EXPECT_EQ(program.instructions[0].sustain_ms, 20'000);
+    EXPECT_EQ(program.instructions[1].op, gg::rules::opcode::fire);
+    EXPECT_EQ(program.instructions[0].next_rule, 2);
+    EXPECT_EQ(program.instructions[2].next_rule, 5);
+    EXPECT_EQ(program.instructions[4].act, action::block);
+}
+
+TEST(rules, compile_invalid_rules) {
+    auto program = gg::rules::program{};
+    for (auto text : {"",
+                      "ping > => warn",
+                      "ping > 300",
+                      "ping > 300 => explode",
+                      "ping >= 300 => warn",
+                      "ping > 300 for forever => warn",
+                      "level outside 713-1 => warn",
+                      "level outside 1 => warn",
+                      "name matches \"unterminated => warn",
+                      "ping > 300 and => warn",
+                      "ping > 300 => warn extra"}) {
+        EXPECT_FALSE(gg::rules::compile("invalid", text, program)) << text;
+    }
+
+    EXPECT_TRUE(program.empty());
+    EXPECT_TRUE(program.instructions.empty());
+    EXPECT_TRUE(program.patterns.empty());
+    EXPECT_EQ(program.timer_count, 0);
+}
+
+TEST(rules, evaluate_fires_once_per_match) {
+    auto program = compile_all({{"twink", "level < 30 and ping > 200 => block"}});
+    auto evaluator = gg::rules::evaluator{program};
+
+    auto players = vector<player_facts>{player(1, 250, 20), player(2, 250, 100)};
+    auto matches = vector<match>{};
+    evaluator.evaluate(players, 0, matches);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].steam_id, 1);
+    EXPECT_EQ(matches[0].rule, 0);
+    EXPECT_EQ(matches[0].act, action::block);
+
+    // Still matching, so it doesn't fire again
+    matches.clear();
+    evaluator.evaluate(players, 100, matches);
+    EXPECT_TRUE(matches.empty());
+
+    // Stops matching, then matches again
+    players[0].ping = 50;
+    evaluator.evaluate(players, 200, matches);
+    EXPECT_TRUE(matches.empty());
+    players[0].ping = 250;
+    evaluator.evaluate(players, 300, matches);
+    EXPECT_EQ(matches.size(), 1);
+}
+
+TEST(rules, evaluate_name_matches) {
+    auto program = compile_all({{"name", "name matches \"*SOLO?\" => warn"}});
+    auto evaluator = gg::rules::evaluator{program};
+
+    auto matches = vector<match>{};
+    evaluator.evaluate(vector{player(1, 50, 100, "let me solo her"), player(2, 50, 100, "solo"),
+                              player(3, 50, 100, "xsolo!")},
+                       0, matches);
+    ASSERT_EQ(matches.size(), 1);
+    EXPECT_EQ(matches[0].steam_id, 3);
+}
+
+TEST(rules, evaluate_sustained_conditions) {
+    auto program = compile_all({{"laggy", "ping > 300 for 20s => warn"}});
+    auto evaluator = gg::rules::evaluator{program};
+
+    auto players = vector{player(1, 400, 100)};
+    auto matches = vector<match>{};
+    evaluator.evaluate(players, 0, matches);
+    evaluator.evaluate(players, 19'999, matches);
+    EXPECT_TRUE(matches.empty());
+    evaluator.evaluate(players, 20'000, matches);
+    EXPECT_EQ(matches.size(), 1);
+
+    // Dropping below the threshold restarts the timer
+    matches.clear();
+    players[0].ping = 100;
+    evaluator.evaluate(players, 21'000, matches);
+    players[0].ping = 400;
+    evaluator.evaluate(players, 22'000, matches);
+    evaluator.evaluate(players, 41'999, matches);
+    EXPECT_TRUE(matches.empty());
+    evaluator.evaluate(players, 42'000, matches);
+    EXPECT_EQ(matches.size(), 1);
+}
+
+TEST(rules, evaluate_forgets_players_who_left) {
+    auto program = compile_all({{"laggy", "ping > 300 for 20s => warn"}});
+    auto evaluator = gg::rules::evaluator{program};
+
+    auto matches = vector<match>{};
+    evaluator.evaluate(vector{player(1, 400, 100)}, 0, matches);
+    evaluator.evaluate(vector<player_facts>{}, 10'000, matches);
+    evaluator.evaluate(vector{player(1, 400, 100)}, 20'000, matches);
+    EXPECT_TRUE(matches.empty());
+    evaluator.evaluate(vector{player(1, 400, 100)}, 40'000, matches);
+    EXPECT_EQ(matches.size(), 1);
+}
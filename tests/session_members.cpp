@@ -0,0 +1,83 @@
+#include "session_members.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace std;
+
+using gg::session_members::event_type;
+using gg::session_members::member;
+
+/**
+ * Stand-ins for PlayerIns, which are only compared by address
+ */
+static int player_a, player_b, player_c;
+
+TEST(session_members, join) {
+    auto tracker = gg::session_members::tracker{};
+    auto members = vector<member>{{&player_a, 1}, {}, {&player_b, 2}};
+
+    auto events = tracker.update(members);
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].type, event_type::join);
+    EXPECT_EQ(events[0].slot, 0);
+    EXPECT_EQ(events[0].player, &player_a);
+    EXPECT_EQ(events[0].steam_id, 1);
+    EXPECT_EQ(events[1].type, event_type::join);
+    EXPECT_EQ(events[1].slot, 2);
+    EXPECT_EQ(events[1].steam_id, 2);
+
+    EXPECT_TRUE(tracker.update(members).empty());
+}
+
+TEST(session_members, leave) {
+    auto tracker = gg::session_members::tracker{};
+    tracker.update(vector<member>{{&player_a, 1}, {&player_b, 2}});
+
+    auto events = tracker.update(vector<member>{{&player_a, 1}, {}});
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, event_type::leave);
+    EXPECT_EQ(events[0].slot, 1);
+    EXPECT_EQ(events[0].player, nullptr);
+    EXPECT_EQ(events[0].previous_steam_id, 2);
+}
+
+TEST(session_members, shrinking_session_leaves) {
+    auto tracker = gg::session_members::tracker{};
+    tracker.update(vector<member>{{&player_a, 1}, {&player_b, 2}});
+
+    auto events = tracker.update(vector<member>{{&player_a, 1}});
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, event_type::leave);
+    EXPECT_EQ(events[0].slot, 1);
+    EXPECT_EQ(events[0].previous_steam_id, 2);
+}
+
+TEST(session_members, replace) {
+    auto tracker = gg::session_members::tracker{};
+    tracker.update(vector<member>{{&player_a, 1}, {&player_b, 2}});
+
+    // The same player with a new character after a loading screen, and a different player
+    // taking over a slot
+    auto events = tracker.update(vector<member>{{&player_c, 1}, {&player_b, 3}});
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].type, event_type::replace);
+    EXPECT_EQ(events[0].player, &player_c);
+    EXPECT_EQ(events[0].steam_id, 1);
+    EXPECT_EQ(events[0].previous_steam_id, 1);
+    EXPECT_EQ(events[1].type, event_type::replace);
+    EXPECT_EQ(events[1].steam_id, 3);
+    EXPECT_EQ(events[1].previous_steam_id, 2);
+}
+
+TEST(session_members, reset) {
+    auto tracker = gg::session_members::tracker{};
+    auto members = vector<member>{{&player_a, 1}};
+    tracker.update(members);
+    tracker.reset();
+
+    auto events = tracker.update(members);
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].type, event_type::join);
+}
@@ -0,0 +1,70 @@
+#include "steam_id_set.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+TEST(steam_id_set, empty) {
+    auto set = gg::steam_id_set{};
+    EXPECT_TRUE(set.empty());
+    EXPECT_FALSE(set.contains(76561197960287930ull));
+    EXPECT_FALSE(set.contains(0));
+}
+
+TEST(steam_id_set, sorts_and_removes_duplicates) {
+    auto set = gg::steam_id_set{{30, 10, 20, 10, 30}};
+    EXPECT_EQ(set.ids(), (vector<uint64_t>{10, 20, 30}));
+    EXPECT_TRUE(set.contains(10));
+    EXPECT_TRUE(set.contains(20));
+    EXPECT_TRUE(set.contains(30));
+    EXPECT_FALSE(set.contains(15));
+}
+
+TEST(steam_id_set, ignores_zero) {
+    auto set = gg::steam_id_set{{0, 5}};
+    EXPECT_EQ(set.size(), 1);
+    EXPECT_FALSE(set.contains(0));
+}
+
+TEST(steam_id_set, with_and_without) {
+    auto set = gg::steam_id_set{{10, 30}};
+
+    auto added = set.with(20);
+    EXPECT_EQ(added.ids(), (vector<uint64_t>{10, 20, 30}));
+    EXPECT_FALSE(set.contains(20));
+
+    EXPECT_EQ(added.with(20).size(), 3);
+
+    auto removed = added.without(10);
+    EXPECT_EQ(removed.ids(), (vector<uint64_t>{20, 30}));
+    EXPECT_FALSE(removed.contains(10));
+
+    auto ids = vector<uint64_t>{20, 30, 40};
+    EXPECT_EQ(added.without(ids).ids(), vector<uint64_t>{10});
+}
+
+TEST(steam_id_set, large_set) {
+    auto rng = mt19937_64{1};
+    auto ids = vector<uint64_t>(100'000);
+    for (auto &id : ids) {
+        id = 76561197960265728ull + (rng() & 0xffffffff);
+    }
+
+    auto set = gg::steam_id_set{ids};
+    for (auto id : ids) {
+        ASSERT_TRUE(set.contains(id));
+    }
+
+    // None of the sorted IDs' neighbours that aren't in the list should be found
+    size_t false_matches = 0;
+    for (auto id : set.ids()) {
+        if (!ranges::binary_search(set.ids(), id + 1) && set.contains(id + 1)) {
+            false_matches++;
+        }
+    }
+    EXPECT_EQ(false_matches, 0);
+}
@@ -0,0 +1,117 @@
+#include "timer_wheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+using expired_timers = vector<pair<uint64_t, int64_t>>;
+
+static expired_timers advance_to(gg::timer_wheel &wheel, int64_t tick) {
+    auto expired = expired_timers{};
+    wheel.advance(tick, [&](uint64_t id, int64_t expires) { expired.emplace_back(id, expires); });
+    return expired;
+}
+
+TEST(timer_wheel, fires_at_expiration) {
+    auto wheel = gg::timer_wheel{100};
+    wheel.add(1, 105);
+    wheel.add(2, 103);
+    EXPECT_EQ(wheel.size(), 2);
+
+    EXPECT_TRUE(advance_to(wheel, 102).empty());
+    EXPECT_EQ(advance_to(wheel, 103), (expired_timers{{2, 103}}));
+    EXPECT_EQ(advance_to(wheel, 104), expired_timers{});
+    EXPECT_EQ(advance_to(wheel, 105), (expired_timers{{1, 105}}));
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST(timer_wheel, past_timers_fire_on_next_tick) {
+    auto wheel = gg::timer_wheel{100};
+    wheel.add(1, 50);
+    wheel.add(2, 100);
+    auto expired = advance_to(wheel, 101);
+    ranges::sort(expired);
+    EXPECT_EQ(expired, (expired_timers{{1, 50}, {2, 100}}));
+}
+
+TEST(timer_wheel, advancing_backwards_does_nothing) {
+    auto wheel = gg::timer_wheel{100};
+    wheel.add(1, 101);
+    EXPECT_TRUE(advance_to(wheel, 90).empty());
+    EXPECT_EQ(wheel.size(), 1);
+    EXPECT_EQ(advance_to(wheel, 101), (expired_timers{{1, 101}}));
+}
+
+TEST(timer_wheel, cascades_from_higher_levels) {
+    // Spread timers across every level of the wheel and past the end of it
+    auto start = int64_t{12345};
+    auto offsets = vector<int64_t>{1, 63, 64, 65, 4095, 4096, 4097, 262143, 262144, 20'000'000};
+
+    auto wheel = gg::timer_wheel{start};
+    for (size_t i = 0; i < offsets.size(); i++) {
+        wheel.add(i, start + offsets[i]);
+    }
+
+    // Step in small increments so every timer cascades down instead of being re-inserted
+    auto fired = vector<int64_t>(offsets.size(), -1);
+    auto tick = start;
+    while (wheel.size() > 0 && tick < start + 20'000'000) {
+        tick += 1000;
+        wheel.advance(tick, [&](uint64_t id, int64_t expires) {
+            EXPECT_EQ(expires, start + offsets[id]);
+            EXPECT_EQ(fired[id], -1);
+            fired[id] = tick;
+        });
+    }
+
+    for (size_t i = 0; i < offsets.size(); i++) {
+        EXPECT_GE(fired[i], start + offsets[i]) << i;
+        EXPECT_LT(fired[i], start + offsets[i] + 1000) << i;
+    }
+}
+
+TEST(timer_wheel, large_jump_fires_everything_due) {
+    auto wheel = gg::timer_wheel{0};
+    wheel.add(1, 10);
+    wheel.add(2, 100'000);
+    wheel.add(3, 200'000);
+
+    auto expired = advance_to(wheel, 150'000);
+    ranges::sort(expired);
+    EXPECT_EQ(expired, (expired_timers{{1, 10}, {2, 100'000}}));
+    EXPECT_EQ(wheel.size(), 1);
+
+    EXPECT_TRUE(advance_to(wheel, 199'999).empty());
+    EXPECT_EQ(advance_to(wheel, 200'000), (expired_timers{{3, 200'000}}));
+}
+
+TEST(timer_wheel, random_timers_fire_once_on_time) {
+    auto rng = mt19937_64{42};
+    auto start = int64_t{1'700'000'000};
+    auto wheel = gg::timer_wheel{start};
+
+    auto expirations = vector<int64_t>(5000);
+    for (size_t i = 0; i < expirations.size(); i++) {
+        expirations[i] = start + static_cast<int64_t>(rng() % 100'000);
+        wheel.add(i, expirations[i]);
+    }
+
+    auto fired = vector<int>(expirations.size());
+    auto tick = start;
+    while (wheel.size() > 0) {
+        tick += static_cast<int64_t>(rng() % 50) + 1;
+        wheel.advance(tick, [&](uint64_t id, int64_t expires) {
+            EXPECT_EQ(expires, expirations[id]);
+            EXPECT_LE(expires, tick);
+            fired[id]++;
+        });
+    }
+
+    EXPECT_TRUE(ranges::all_of(fired, [](int count) { return count == 1; }));
+}
@@ -0,0 +1,34 @@
+#include "utf8.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+using namespace std;
+
+TEST(utf8, copy_truncated_fits) {
+    auto buffer = array<char, 8>{};
+    buffer.fill('x');
+    gg::utf8::copy_truncated(buffer, "abc");
+    EXPECT_EQ(string_view{buffer.data()}, "abc");
+    EXPECT_TRUE(ranges::all_of(buffer.begin() + 3, buffer.end(), [](char c) { return c == 0; }));
+}
+
+TEST(utf8, copy_truncated_leaves_room_for_terminator) {
+    auto buffer = array<char, 4>{};
+    gg::utf8::copy_truncated(buffer, "abcdef");
+    EXPECT_EQ(string_view{buffer.data()}, "abc");
+}
+
+TEST(utf8, copy_truncated_keeps_whole_characters) {
+    // Three 3-byte characters, so only one fits in 6 bytes with the terminator
+    auto buffer = array<char, 6>{};
+    gg::utf8::copy_truncated(buffer, "\xe8\xa4\xaa\xe8\x89\xb2\xe8\x80\x85");
+    EXPECT_EQ(string_view{buffer.data()}, "\xe8\xa4\xaa");
+
+    auto exact = array<char, 7>{};
+    gg::utf8::copy_truncated(exact, "\xe8\xa4\xaa\xe8\x89\xb2\xe8\x80\x85");
+    EXPECT_EQ(string_view{exact.data()}, "\xe8\xa4\xaa\xe8\x89\xb2");
+}